@@ -0,0 +1,409 @@
+#include "vector.h"
+#include "benchmark_utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Микробенчмарки Vector в сравнении с std::vector: время операции, а также число выделений
+// памяти и пиковый объём буферов контейнера в измеряемой части сценария.
+// Запуск: benchmark [--max-size=N] [--filter=подстрока] [--min-time-ms=M]
+
+namespace {
+
+using namespace std::literals;
+
+// Тип, перемещающий конструктор которого может выбросить исключение:
+// контейнер вынужден копировать его при реаллокации
+struct ThrowingMove {
+    ThrowingMove() = default;
+    explicit ThrowingMove(int value)
+        : payload(LONG_STRING)
+        , value(value) {
+    }
+    ThrowingMove(const ThrowingMove&) = default;
+    ThrowingMove(ThrowingMove&& other) noexcept(false)
+        : payload(std::move(other.payload))
+        , value(other.value) {
+    }
+    ThrowingMove& operator=(const ThrowingMove&) = default;
+    ThrowingMove& operator=(ThrowingMove&&) noexcept(false) = default;
+
+    std::string payload;
+    int value = 0;
+};
+
+template <typename T>
+int ValueOf(const T& value) {
+    if constexpr (std::is_same_v<T, std::string>) {
+        return static_cast<int>(value.size());
+    } else if constexpr (std::is_same_v<T, ThrowingMove>) {
+        return value.value;
+    } else {
+        return static_cast<int>(value);
+    }
+}
+
+// Выделения памяти контейнерами через CountingAllocator. Выделения учитываются только
+// в измеряемой части сценария, пиковый объём включает и уже существующие буферы
+struct AllocationStats {
+    size_t allocations = 0;
+    size_t live_bytes = 0;
+    size_t peak_bytes = 0;
+    bool counting = false;
+};
+
+AllocationStats& GetAllocationStats() {
+    static AllocationStats stats;
+    return stats;
+}
+
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+
+    CountingAllocator() = default;
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>& /*other*/) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        T* p = std::allocator<T>().allocate(n);
+        AllocationStats& stats = GetAllocationStats();
+        stats.live_bytes += n * sizeof(T);
+        if (stats.counting) {
+            ++stats.allocations;
+            stats.peak_bytes = std::max(stats.peak_bytes, stats.live_bytes);
+        }
+        return p;
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        GetAllocationStats().live_bytes -= n * sizeof(T);
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    friend bool operator==(const CountingAllocator&, const CountingAllocator&) noexcept {
+        return true;
+    }
+};
+
+// Секундомер измеряемой части, заодно включающий учёт выделений памяти
+class MeteredStopwatch : public Stopwatch {
+public:
+    void Start() {
+        AllocationStats& stats = GetAllocationStats();
+        stats.counting = true;
+        stats.peak_bytes = std::max(stats.peak_bytes, stats.live_bytes);
+        Stopwatch::Start();
+    }
+
+    void Stop() {
+        Stopwatch::Stop();
+        GetAllocationStats().counting = false;
+    }
+};
+
+template <typename T>
+using BenchVector = Vector<T, CountingAllocator<T>>;
+
+template <typename T>
+using BenchStdVector = std::vector<T, CountingAllocator<T>>;
+
+// Единый интерфейс к Vector и std::vector
+template <typename T, typename Allocator>
+void PushBack(Vector<T, Allocator>& v, const T& value) {
+    v.PushBack(value);
+}
+
+template <typename T, typename Allocator>
+void PushBack(std::vector<T, Allocator>& v, const T& value) {
+    v.push_back(value);
+}
+
+template <typename T, typename Allocator>
+void EmplaceBack(Vector<T, Allocator>& v, int value) {
+    v.EmplaceBack(MakeValue<T>(value));
+}
+
+template <typename T, typename Allocator>
+void EmplaceBack(std::vector<T, Allocator>& v, int value) {
+    v.emplace_back(MakeValue<T>(value));
+}
+
+template <typename T, typename Allocator>
+void InsertMiddle(Vector<T, Allocator>& v, const T& value) {
+    v.Insert(v.cbegin() + v.Size() / 2, value);
+}
+
+template <typename T, typename Allocator>
+void InsertMiddle(std::vector<T, Allocator>& v, const T& value) {
+    v.insert(v.begin() + v.size() / 2, value);
+}
+
+template <typename T, typename Allocator>
+void EraseMiddle(Vector<T, Allocator>& v) {
+    v.Erase(v.cbegin() + v.Size() / 2);
+}
+
+template <typename T, typename Allocator>
+void EraseMiddle(std::vector<T, Allocator>& v) {
+    v.erase(v.begin() + v.size() / 2);
+}
+
+template <typename T, typename Allocator>
+void Reserve(Vector<T, Allocator>& v, size_t capacity) {
+    v.Reserve(capacity);
+}
+
+template <typename T, typename Allocator>
+void Reserve(std::vector<T, Allocator>& v, size_t capacity) {
+    v.reserve(capacity);
+}
+
+template <typename Container>
+Container MakeFilled(size_t size) {
+    using T = std::decay_t<decltype(*std::declval<Container&>().begin())>;
+    Container v;
+    Reserve(v, size);
+    for (size_t i = 0; i < size; ++i) {
+        PushBack(v, MakeValue<T>(i));
+    }
+    return v;
+}
+
+struct Options {
+    size_t max_size = 1'000'000;
+    std::string filter;
+    std::chrono::milliseconds min_time{100};
+};
+
+// Каждый сценарий шаблонный по контейнеру, измеряет свою основную часть
+// и возвращает число выполненных операций
+struct PushBackCase {
+    static constexpr std::string_view NAME = "PushBack"sv;
+
+    template <typename Container, typename T, typename Timer>
+    static size_t Run(size_t size, Timer& stopwatch) {
+        const T value = MakeValue<T>(1);
+        stopwatch.Start();
+        Container v;
+        for (size_t i = 0; i < size; ++i) {
+            PushBack(v, value);
+        }
+        DoNotOptimize(v);
+        stopwatch.Stop();
+        return size;
+    }
+};
+
+struct EmplaceBackCase {
+    static constexpr std::string_view NAME = "EmplaceBack"sv;
+
+    template <typename Container, typename T, typename Timer>
+    static size_t Run(size_t size, Timer& stopwatch) {
+        stopwatch.Start();
+        Container v;
+        for (size_t i = 0; i < size; ++i) {
+            EmplaceBack(v, static_cast<int>(i));
+        }
+        DoNotOptimize(v);
+        stopwatch.Stop();
+        return size;
+    }
+};
+
+// Вставка и удаление в середине квадратичны, поэтому число операций ограничено
+inline constexpr size_t MAX_MIDDLE_OPERATIONS = 1'000;
+
+struct InsertMiddleCase {
+    static constexpr std::string_view NAME = "Insert(middle)"sv;
+
+    template <typename Container, typename T, typename Timer>
+    static size_t Run(size_t size, Timer& stopwatch) {
+        const size_t operations = std::min(size, MAX_MIDDLE_OPERATIONS);
+        Container v = MakeFilled<Container>(size);
+        const T value = MakeValue<T>(1);
+        stopwatch.Start();
+        for (size_t i = 0; i < operations; ++i) {
+            InsertMiddle(v, value);
+        }
+        DoNotOptimize(v);
+        stopwatch.Stop();
+        return operations;
+    }
+};
+
+struct EraseMiddleCase {
+    static constexpr std::string_view NAME = "Erase(middle)"sv;
+
+    template <typename Container, typename T, typename Timer>
+    static size_t Run(size_t size, Timer& stopwatch) {
+        const size_t operations = std::min(size, MAX_MIDDLE_OPERATIONS);
+        Container v = MakeFilled<Container>(size);
+        stopwatch.Start();
+        for (size_t i = 0; i < operations; ++i) {
+            EraseMiddle(v);
+        }
+        DoNotOptimize(v);
+        stopwatch.Stop();
+        return operations;
+    }
+};
+
+struct ReserveCase {
+    static constexpr std::string_view NAME = "Reserve(x2)"sv;
+
+    template <typename Container, typename T, typename Timer>
+    static size_t Run(size_t size, Timer& stopwatch) {
+        Container v = MakeFilled<Container>(size);
+        stopwatch.Start();
+        Reserve(v, size * 2);
+        DoNotOptimize(v);
+        stopwatch.Stop();
+        return size;
+    }
+};
+
+struct CopyAssignCase {
+    static constexpr std::string_view NAME = "CopyAssign"sv;
+
+    template <typename Container, typename T, typename Timer>
+    static size_t Run(size_t size, Timer& stopwatch) {
+        const Container source = MakeFilled<Container>(size);
+        Container v;
+        stopwatch.Start();
+        v = source;
+        DoNotOptimize(v);
+        stopwatch.Stop();
+        return size;
+    }
+};
+
+struct MoveAssignCase {
+    static constexpr std::string_view NAME = "MoveAssign"sv;
+
+    template <typename Container, typename T, typename Timer>
+    static size_t Run(size_t size, Timer& stopwatch) {
+        Container source = MakeFilled<Container>(size);
+        Container v;
+        stopwatch.Start();
+        v = std::move(source);
+        DoNotOptimize(v);
+        stopwatch.Stop();
+        return 1;
+    }
+};
+
+struct IterateCase {
+    static constexpr std::string_view NAME = "Iterate"sv;
+
+    template <typename Container, typename T, typename Timer>
+    static size_t Run(size_t size, Timer& stopwatch) {
+        const Container v = MakeFilled<Container>(size);
+        stopwatch.Start();
+        int64_t sum = 0;
+        for (const T& value : v) {
+            sum += ValueOf(value);
+        }
+        DoNotOptimize(sum);
+        stopwatch.Stop();
+        return size;
+    }
+};
+
+// Выделения памяти за один запуск сценария
+struct AllocationResult {
+    size_t allocations = 0;
+    size_t peak_bytes = 0;
+};
+
+template <typename Case, typename Container, typename T>
+AllocationResult MeasureAllocations(size_t size) {
+    GetAllocationStats() = {};
+    MeteredStopwatch stopwatch;
+    Case::template Run<Container, T>(size, stopwatch);
+    const AllocationStats& stats = GetAllocationStats();
+    return {stats.allocations, stats.peak_bytes};
+}
+
+template <typename Case, typename T>
+void RunCase(const Options& options, std::string_view type_name) {
+    for (size_t size = 1; size <= options.max_size; size *= 10) {
+        std::ostringstream name;
+        name << Case::NAME << '/' << type_name << '/' << size;
+        if (name.str().find(options.filter) == std::string::npos) {
+            continue;
+        }
+        const double vector_ns = MeasureNsPerOp(options.min_time, [size](Stopwatch& stopwatch) {
+            return Case::template Run<BenchVector<T>, T>(size, stopwatch);
+        });
+        const double std_ns = MeasureNsPerOp(options.min_time, [size](Stopwatch& stopwatch) {
+            return Case::template Run<BenchStdVector<T>, T>(size, stopwatch);
+        });
+        const AllocationResult vector_memory = MeasureAllocations<Case, BenchVector<T>, T>(size);
+        const AllocationResult std_memory = MeasureAllocations<Case, BenchStdVector<T>, T>(size);
+        std::cout << std::left << std::setw(36) << name.str() << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(14) << vector_ns << std::setw(14) << std_ns << std::setw(10) << vector_ns / std_ns
+                  << std::setw(12) << vector_memory.allocations << std::setw(12) << std_memory.allocations
+                  << std::setw(16) << vector_memory.peak_bytes << std::setw(16) << std_memory.peak_bytes << '\n';
+    }
+}
+
+template <typename T>
+void RunAllCases(const Options& options, std::string_view type_name) {
+    RunCase<PushBackCase, T>(options, type_name);
+    RunCase<EmplaceBackCase, T>(options, type_name);
+    RunCase<InsertMiddleCase, T>(options, type_name);
+    RunCase<EraseMiddleCase, T>(options, type_name);
+    RunCase<ReserveCase, T>(options, type_name);
+    RunCase<CopyAssignCase, T>(options, type_name);
+    RunCase<MoveAssignCase, T>(options, type_name);
+    RunCase<IterateCase, T>(options, type_name);
+}
+
+Options ParseOptions(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg.starts_with("--max-size="sv)) {
+            options.max_size = std::stoull(std::string(arg.substr("--max-size="sv.size())));
+        } else if (arg.starts_with("--filter="sv)) {
+            options.filter = arg.substr("--filter="sv.size());
+        } else if (arg.starts_with("--min-time-ms="sv)) {
+            options.min_time = std::chrono::milliseconds(std::stoll(std::string(arg.substr("--min-time-ms="sv.size()))));
+        } else {
+            throw std::invalid_argument("Unknown argument: "s + std::string(arg));
+        }
+    }
+    return options;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        const Options options = ParseOptions(argc, argv);
+        std::cout << std::left << std::setw(36) << "benchmark" << std::right << std::setw(14) << "Vector ns/op"
+                  << std::setw(14) << "std ns/op" << std::setw(10) << "ratio" << std::setw(12) << "V allocs"
+                  << std::setw(12) << "std allocs" << std::setw(16) << "V peak bytes" << std::setw(16)
+                  << "std peak bytes" << '\n';
+        RunAllCases<int>(options, "int"sv);
+        RunAllCases<std::string>(options, "string"sv);
+        RunAllCases<ThrowingMove>(options, "throwing_move"sv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+
+// Общие средства замеров для бенчмарков и регрессионного набора
+
+// Строка длиннее буфера SSO — копирование требует выделения памяти
+inline const std::string LONG_STRING = "string that does not fit into the small buffer";
+
+// Значение элемента для заполнения векторов: для строк — LONG_STRING, иначе T(i)
+template <typename T>
+T MakeValue(size_t i) {
+    if constexpr (std::is_same_v<T, std::string>) {
+        return LONG_STRING;
+    } else {
+        return T(static_cast<int>(i));
+    }
+}
+
+// Не даёт компилятору выбросить вычисления, результат которых не используется
+template <typename T>
+void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// Накапливает время только измеряемой части сценария, без подготовки данных
+class Stopwatch {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void Start() {
+        start_ = Clock::now();
+    }
+
+    void Stop() {
+        elapsed_ += Clock::now() - start_;
+    }
+
+    Clock::duration Elapsed() const {
+        return elapsed_;
+    }
+
+private:
+    Clock::time_point start_;
+    Clock::duration elapsed_{};
+};
+
+// Повторяет run(stopwatch), возвращающую число выполненных операций, до накопления
+// min_time измеренного времени и возвращает среднее время одной операции в наносекундах
+template <typename Run>
+double MeasureNsPerOp(std::chrono::nanoseconds min_time, Run&& run) {
+    Stopwatch stopwatch;
+    size_t operations = 0;
+    do {
+        operations += run(stopwatch);
+    } while (stopwatch.Elapsed() < min_time);
+    return std::chrono::duration<double, std::nano>(stopwatch.Elapsed()).count() / static_cast<double>(operations);
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+// Вектор с потокобезопасным добавлением элементов без блокировок. Память состоит из сегментов,
+// размеры которых растут как степени двойки, поэтому добавленные элементы никогда
+// не перемещаются. EmplaceBack захватывает индекс атомарным счётчиком и возвращает его;
+// элемент становится видимым для других потоков (IsPublished) после завершения
+// конструктора. Сегмент устанавливается через compare_exchange: если его одновременно
+// выделили несколько потоков, проигравшие освобождают свои блоки. Выделение не конструирует
+// элементы и обнуляет лишь битовую карту опубликованных, поэтому лишний блок стоит только памяти.
+// Удаление элементов и изменение вместимости в обход Reserve не поддерживаются
+template <typename T, size_t FirstSegmentSize = 64>
+class ConcurrentVector {
+    static_assert(std::has_single_bit(FirstSegmentSize), "FirstSegmentSize must be a power of two");
+
+public:
+    ConcurrentVector() = default;
+
+    ConcurrentVector(const ConcurrentVector&) = delete;
+    ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+
+    ~ConcurrentVector() {
+        const size_t size = std::min(claimed_.load(std::memory_order_acquire), MaxSize());
+        for (size_t segment = 0; segment < MAX_SEGMENTS; ++segment) {
+            std::byte* block = segments_[segment].load(std::memory_order_acquire);
+            if (block == nullptr) {
+                continue;
+            }
+            const size_t begin = SegmentBegin(segment);
+            for (size_t offset = 0; offset < SegmentSize(segment) && begin + offset < size; ++offset) {
+                if (IsReady(block, offset)) {
+                    std::destroy_at(Element(block, segment, offset));
+                }
+            }
+            FreeSegment(block);
+        }
+    }
+
+    // Создаёт элемент и возвращает его индекс. Если конструктор выбросит исключение,
+    // захваченный индекс останется неопубликованным
+    template <typename... Args>
+    size_t EmplaceBack(Args&&... args) {
+        const size_t index = claimed_.fetch_add(1, std::memory_order_relaxed);
+        if (index >= MaxSize()) {
+            throw std::length_error("ConcurrentVector is full");
+        }
+        const auto [segment, offset] = Locate(index);
+        std::byte* block = AcquireSegment(segment);
+        new (Element(block, segment, offset)) T(std::forward<Args>(args)...);
+        ReadyWord(block, offset).fetch_or(ReadyBit(offset), std::memory_order_release);
+        return index;
+    }
+
+    size_t PushBack(const T& value) {
+        return EmplaceBack(value);
+    }
+
+    size_t PushBack(T&& value) {
+        return EmplaceBack(std::move(value));
+    }
+
+    // Заранее выделяет сегменты для capacity элементов
+    void Reserve(size_t capacity) {
+        for (size_t segment = 0; segment < MAX_SEGMENTS && SegmentBegin(segment) < capacity; ++segment) {
+            AcquireSegment(segment);
+        }
+    }
+
+    // Число захваченных индексов. Элементы с индексами меньше Size() могут быть
+    // ещё не опубликованы
+    size_t Size() const noexcept {
+        return std::min(claimed_.load(std::memory_order_acquire), MaxSize());
+    }
+
+    // Элемент index создан, и его можно читать из любого потока
+    bool IsPublished(size_t index) const noexcept {
+        if (index >= Size()) {
+            return false;
+        }
+        const auto [segment, offset] = Locate(index);
+        std::byte* block = segments_[segment].load(std::memory_order_acquire);
+        return block != nullptr && IsReady(block, offset);
+    }
+
+    // Доступ допустим только к опубликованным элементам
+    const T& operator[](size_t index) const noexcept {
+        assert(IsPublished(index));
+        const auto [segment, offset] = Locate(index);
+        return *Element(segments_[segment].load(std::memory_order_acquire), segment, offset);
+    }
+
+    T& operator[](size_t index) noexcept {
+        return const_cast<T&>(std::as_const(*this)[index]);
+    }
+
+    static constexpr size_t MaxSize() noexcept {
+        return SegmentBegin(MAX_SEGMENTS - 1) + SegmentSize(MAX_SEGMENTS - 1);
+    }
+
+private:
+    using ReadyBits = std::atomic<uint64_t>;
+
+    static constexpr size_t FIRST_SEGMENT_BITS = std::countr_zero(FirstSegmentSize);
+    // Сегмент k содержит FirstSegmentSize << k элементов
+    static constexpr size_t MAX_SEGMENTS = std::numeric_limits<size_t>::digits - FIRST_SEGMENT_BITS;
+    static constexpr size_t READY_WORD_BITS = std::numeric_limits<uint64_t>::digits;
+    static constexpr std::align_val_t SEGMENT_ALIGNMENT{std::max(alignof(T), alignof(ReadyBits))};
+
+    // Блок сегмента: битовая карта опубликованных элементов, затем память под элементы
+    std::atomic<std::byte*> segments_[MAX_SEGMENTS] = {};
+    std::atomic<size_t> claimed_{0};
+
+    static constexpr size_t SegmentSize(size_t segment) noexcept {
+        return FirstSegmentSize << segment;
+    }
+
+    static constexpr size_t SegmentBegin(size_t segment) noexcept {
+        return SegmentSize(segment) - FirstSegmentSize;
+    }
+
+    static constexpr size_t ReadyWords(size_t segment) noexcept {
+        return (SegmentSize(segment) + READY_WORD_BITS - 1) / READY_WORD_BITS;
+    }
+
+    // Смещение элементов в блоке, выровненное под T
+    static constexpr size_t ElementsOffset(size_t segment) noexcept {
+        const size_t bitmap = ReadyWords(segment) * sizeof(ReadyBits);
+        return (bitmap + alignof(T) - 1) / alignof(T) * alignof(T);
+    }
+
+    static std::pair<size_t, size_t> Locate(size_t index) noexcept {
+        const size_t biased = index + FirstSegmentSize;
+        const size_t segment = std::bit_width(biased) - 1 - FIRST_SEGMENT_BITS;
+        return {segment, biased - SegmentSize(segment)};
+    }
+
+    static ReadyBits& ReadyWord(std::byte* block, size_t offset) noexcept {
+        return std::launder(reinterpret_cast<ReadyBits*>(block))[offset / READY_WORD_BITS];
+    }
+
+    static constexpr uint64_t ReadyBit(size_t offset) noexcept {
+        return uint64_t{1} << (offset % READY_WORD_BITS);
+    }
+
+    static bool IsReady(std::byte* block, size_t offset) noexcept {
+        return (ReadyWord(block, offset).load(std::memory_order_acquire) & ReadyBit(offset)) != 0;
+    }
+
+    static T* Element(std::byte* block, size_t segment, size_t offset) noexcept {
+        return std::launder(reinterpret_cast<T*>(block + ElementsOffset(segment))) + offset;
+    }
+
+    // Элементы не конструируются, обнуляется только битовая карта
+    static std::byte* AllocateSegment(size_t segment) {
+        const size_t elements = SegmentSize(segment);
+        if (elements > (std::numeric_limits<size_t>::max() - ElementsOffset(segment)) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        auto* block = static_cast<std::byte*>(
+            ::operator new(ElementsOffset(segment) + elements * sizeof(T), SEGMENT_ALIGNMENT));
+        std::uninitialized_value_construct_n(reinterpret_cast<ReadyBits*>(block), ReadyWords(segment));
+        return block;
+    }
+
+    static void FreeSegment(std::byte* block) noexcept {
+        ::operator delete(block, SEGMENT_ALIGNMENT);
+    }
+
+    // Возвращает сегмент, выделяя его при необходимости. Гонку за установку выигрывает один
+    // поток, остальные освобождают свои блоки и используют установленный
+    std::byte* AcquireSegment(size_t segment) {
+        std::atomic<std::byte*>& entry = segments_[segment];
+        std::byte* block = entry.load(std::memory_order_acquire);
+        if (block != nullptr) {
+            return block;
+        }
+        std::byte* allocated = AllocateSegment(segment);
+        if (entry.compare_exchange_strong(block, allocated, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return allocated;
+        }
+        FreeSegment(allocated);
+        return block;
+    }
+};
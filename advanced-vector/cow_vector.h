@@ -0,0 +1,168 @@
+#pragma once
+
+#include "vector.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <utility>
+
+// Вектор с копированием при записи. Копии разделяют один буфер со счётчиком ссылок, поэтому
+// копирование и присваивание стоят O(1). Первый изменяющий вызов у копии, чей буфер
+// разделён с другими, сначала копирует элементы в собственный буфер.
+// Счётчик ссылок атомарный: копии одного буфера можно читать и уничтожать в разных потоках.
+// Один и тот же объект CowVector, как и shared_ptr, нельзя одновременно менять из нескольких потоков
+template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth<>>
+class CowVector {
+public:
+    using Values = Vector<T, Allocator, GrowthPolicy>;
+    using iterator = const T*;
+    using const_iterator = const T*;
+
+    CowVector() = default;
+
+    explicit CowVector(Values values)
+        : shared_(new Shared{std::move(values)}) {
+    }
+
+    CowVector(std::initializer_list<T> values)
+        : CowVector(Values(values)) {
+    }
+
+    CowVector(const CowVector& other) noexcept
+        : shared_(other.shared_) {
+        if (shared_ != nullptr) {
+            shared_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    CowVector(CowVector&& other) noexcept
+        : shared_(std::exchange(other.shared_, nullptr)) {
+    }
+
+    CowVector& operator=(const CowVector& rhs) noexcept {
+        if (this != &rhs) {
+            CowVector copy(rhs);
+            Swap(copy);
+        }
+        return *this;
+    }
+
+    CowVector& operator=(CowVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Release();
+            shared_ = std::exchange(rhs.shared_, nullptr);
+        }
+        return *this;
+    }
+
+    ~CowVector() {
+        Release();
+    }
+
+    void Swap(CowVector& other) noexcept {
+        std::swap(shared_, other.shared_);
+    }
+
+    const_iterator begin() const noexcept {
+        return shared_ != nullptr ? shared_->values.Data() : nullptr;
+    }
+
+    const_iterator end() const noexcept {
+        return shared_ != nullptr ? shared_->values.Data() + shared_->values.Size() : nullptr;
+    }
+
+    size_t Size() const noexcept {
+        return shared_ != nullptr ? shared_->values.Size() : 0;
+    }
+
+    size_t Capacity() const noexcept {
+        return shared_ != nullptr ? shared_->values.Capacity() : 0;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < Size());
+        return shared_->values[index];
+    }
+
+    // Число копий, разделяющих буфер; 0 у пустого вектора без буфера
+    size_t UseCount() const noexcept {
+        return shared_ != nullptr ? shared_->refs.load(std::memory_order_acquire) : 0;
+    }
+
+    const Values& Get() const noexcept {
+        return shared_ != nullptr ? shared_->values : EMPTY;
+    }
+
+    // Возвращает вектор для изменения, предварительно отделив буфер от других копий.
+    // Ссылка действительна до следующего копирования этого объекта
+    Values& Mutate() {
+        Detach();
+        return shared_->values;
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        return Mutate().EmplaceBack(std::forward<Args>(args)...);
+    }
+
+    void PushBack(const T& value) {
+        Mutate().PushBack(value);
+    }
+
+    void PushBack(T&& value) {
+        Mutate().PushBack(std::move(value));
+    }
+
+    void PopBack() {
+        Mutate().PopBack();
+    }
+
+    void Resize(size_t new_size) {
+        Mutate().Resize(new_size);
+    }
+
+    void Reserve(size_t new_capacity) {
+        Mutate().Reserve(new_capacity);
+    }
+
+    // Разделённый буфер не копируется, а просто отпускается
+    void Clear() noexcept {
+        if (shared_ != nullptr && shared_->refs.load(std::memory_order_acquire) == 1) {
+            shared_->values.Clear();
+        } else {
+            Release();
+        }
+    }
+
+private:
+    struct Shared {
+        Values values;
+        std::atomic<size_t> refs = 1;
+    };
+
+    inline static const Values EMPTY;
+
+    Shared* shared_ = nullptr;
+
+    void Detach() {
+        if (shared_ == nullptr) {
+            shared_ = new Shared{};
+        } else if (shared_->refs.load(std::memory_order_acquire) != 1) {
+            // Если остальные копии уничтожатся после проверки, буфер лишь скопируется зря.
+            // Обратное невозможно: счётчик единственного владельца растёт только при копировании
+            // этого же объекта
+            auto* own = new Shared{shared_->values};
+            Release();
+            shared_ = own;
+        }
+    }
+
+    void Release() noexcept {
+        if (shared_ != nullptr && shared_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete shared_;
+        }
+        shared_ = nullptr;
+    }
+};
@@ -0,0 +1,426 @@
+#pragma once
+
+#include "flat_set.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Упорядоченный ассоциативный массив. Ключи и значения лежат в разных векторах: поиск
+// просматривает только плотный массив ключей и не тянет в кэш значения.
+// Разыменование итератора возвращает пару ссылок std::pair<const K&, V&>
+template <typename K, typename V, typename Compare = std::less<K>>
+class FlatMap {
+    template <bool IsConst>
+    class BasicIterator {
+        using Map = std::conditional_t<IsConst, const FlatMap, FlatMap>;
+        using Value = std::conditional_t<IsConst, const V, V>;
+
+    public:
+        // Разыменование возвращает прокси-пару, поэтому по требованиям C++17 это лишь итератор ввода
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::pair<K, V>;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::pair<const K&, Value&>;
+
+        // Пара ссылок живёт внутри указателя, чтобы работало it->first
+        struct pointer {
+            reference ref;
+
+            reference* operator->() noexcept {
+                return &ref;
+            }
+        };
+
+        BasicIterator() = default;
+
+        BasicIterator(Map* map, size_t index) noexcept
+            : map_(map)
+            , index_(index) {
+        }
+
+        // Неконстантный итератор приводится к константному
+        operator BasicIterator<true>() const noexcept {
+            return {map_, index_};
+        }
+
+        reference operator*() const noexcept {
+            return {map_->keys_[index_], map_->values_[index_]};
+        }
+
+        pointer operator->() const noexcept {
+            return {**this};
+        }
+
+        reference operator[](difference_type offset) const noexcept {
+            return *(*this + offset);
+        }
+
+        size_t Index() const noexcept {
+            return index_;
+        }
+
+        BasicIterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        BasicIterator operator++(int) noexcept {
+            BasicIterator result = *this;
+            ++index_;
+            return result;
+        }
+
+        BasicIterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        BasicIterator operator--(int) noexcept {
+            BasicIterator result = *this;
+            --index_;
+            return result;
+        }
+
+        BasicIterator& operator+=(difference_type offset) noexcept {
+            index_ += offset;
+            return *this;
+        }
+
+        BasicIterator& operator-=(difference_type offset) noexcept {
+            index_ -= offset;
+            return *this;
+        }
+
+        friend BasicIterator operator+(BasicIterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        friend BasicIterator operator+(difference_type offset, BasicIterator it) noexcept {
+            return it += offset;
+        }
+
+        friend BasicIterator operator-(BasicIterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend auto operator<=>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ <=> rhs.index_;
+        }
+
+    private:
+        Map* map_ = nullptr;
+        size_t index_ = 0;
+    };
+
+public:
+    using iterator = BasicIterator<false>;
+    using const_iterator = BasicIterator<true>;
+
+    FlatMap() = default;
+
+    explicit FlatMap(const Compare& comp)
+        : comp_(comp) {
+    }
+
+    FlatMap(std::initializer_list<std::pair<K, V>> items, const Compare& comp = Compare())
+        : comp_(comp) {
+        InsertUnsorted(items);
+    }
+
+    iterator begin() noexcept {
+        return {this, 0};
+    }
+
+    iterator end() noexcept {
+        return {this, Size()};
+    }
+
+    const_iterator begin() const noexcept {
+        return {this, 0};
+    }
+
+    const_iterator end() const noexcept {
+        return {this, Size()};
+    }
+
+    size_t Size() const noexcept {
+        return keys_.Size();
+    }
+
+    void Reserve(size_t capacity) {
+        keys_.Reserve(capacity);
+        values_.Reserve(capacity);
+    }
+
+    void Clear() noexcept {
+        keys_.Clear();
+        values_.Clear();
+        index_.Clear();
+    }
+
+    template <typename Key>
+    iterator LowerBound(const Key& key) {
+        return {this, LowerBoundIndex(key)};
+    }
+
+    template <typename Key>
+    const_iterator LowerBound(const Key& key) const {
+        return {this, LowerBoundIndex(key)};
+    }
+
+    template <typename Key>
+    iterator Find(const Key& key) {
+        return {this, FindIndex(key)};
+    }
+
+    template <typename Key>
+    const_iterator Find(const Key& key) const {
+        return {this, FindIndex(key)};
+    }
+
+    template <typename Key>
+    bool Contains(const Key& key) const {
+        return FindIndex(key) != Size();
+    }
+
+    // Выбрасывает std::out_of_range, если ключа нет
+    template <typename Key>
+    V& At(const Key& key) {
+        return values_[CheckedIndex(key)];
+    }
+
+    template <typename Key>
+    const V& At(const Key& key) const {
+        return values_[CheckedIndex(key)];
+    }
+
+    // Вставляет значение по умолчанию, если ключа нет
+    template <typename Key>
+    V& operator[](Key&& key) {
+        return (*TryEmplace(std::forward<Key>(key)).first).second;
+    }
+
+    // Возвращает позицию ключа и true, если пара была добавлена. Имеющееся значение не меняется
+    template <typename Key, typename... Args>
+    std::pair<iterator, bool> TryEmplace(Key&& key, Args&&... args) {
+        const size_t index = LowerBoundIndex(key);
+        if (index != Size() && !comp_(key, keys_[index])) {
+            return {iterator(this, index), false};
+        }
+        InsertAt(index, K(std::forward<Key>(key)), V(std::forward<Args>(args)...));
+        return {iterator(this, index), true};
+    }
+
+    template <typename Key, typename Value>
+    std::pair<iterator, bool> Insert(Key&& key, Value&& value) {
+        return TryEmplace(std::forward<Key>(key), std::forward<Value>(value));
+    }
+
+    template <typename Key, typename Value>
+    std::pair<iterator, bool> InsertOrAssign(Key&& key, Value&& value) {
+        const size_t index = LowerBoundIndex(key);
+        if (index != Size() && !comp_(key, keys_[index])) {
+            values_[index] = std::forward<Value>(value);
+            return {iterator(this, index), false};
+        }
+        InsertAt(index, K(std::forward<Key>(key)), V(std::forward<Value>(value)));
+        return {iterator(this, index), true};
+    }
+
+    template <typename Key>
+        requires(!std::convertible_to<const Key&, const_iterator>)
+    size_t Erase(const Key& key) {
+        const size_t index = FindIndex(key);
+        if (index == Size()) {
+            return 0;
+        }
+        Erase(const_iterator(this, index));
+        return 1;
+    }
+
+    iterator Erase(const_iterator pos) {
+        index_.Clear();
+        keys_.Erase(keys_.begin() + pos.Index());
+        values_.Erase(values_.begin() + pos.Index());
+        return {this, pos.Index()};
+    }
+
+    // Добавляет пары из произвольного диапазона: они дописываются в конец, упорядочиваются
+    // одной сортировкой перестановки и сливаются с имеющимися. Из пар с равными ключами
+    // остаётся первая, уже имевшаяся в массиве или встретившаяся раньше в диапазоне
+    template <std::ranges::input_range Range>
+    void InsertUnsorted(Range&& range) {
+        const size_t old_size = Size();
+        try {
+            for (auto&& item : range) {
+                keys_.EmplaceBack(std::get<0>(std::forward<decltype(item)>(item)));
+                values_.EmplaceBack(std::get<1>(std::forward<decltype(item)>(item)));
+            }
+            if (Size() == old_size) {
+                // Пустой диапазон не меняет пары и не сбрасывает индекс
+                return;
+            }
+            index_.Clear();
+            MergeTail(old_size);
+        } catch (...) {
+            // Дописанные пары убираются, чтобы столбцы остались одной длины и упорядоченными
+            keys_.Erase(keys_.begin() + old_size, keys_.end());
+            values_.Erase(values_.begin() + old_size, values_.end());
+            throw;
+        }
+    }
+
+    // Строит индекс Эйтцингера по ключам, он сбрасывается при любом изменении набора ключей
+    void BuildSearchIndex() {
+        index_.Build(Keys());
+    }
+
+    std::span<const K> Keys() const noexcept {
+        return {keys_.Data(), keys_.Size()};
+    }
+
+    std::span<V> Values() noexcept {
+        return {values_.Data(), values_.Size()};
+    }
+
+    std::span<const V> Values() const noexcept {
+        return {values_.Data(), values_.Size()};
+    }
+
+private:
+    Vector<K> keys_;
+    Vector<V> values_;
+    EytzingerIndex<K, Compare> index_;
+    [[no_unique_address]] Compare comp_;
+
+    // Упорядочивает пары, дописанные после old_size, и сливает их с имеющимися. Сортируется
+    // перестановка индексов, ключи и значения переносятся по ней один раз. Если все новые ключи
+    // больше имеющихся, переставляется только хвост, а имеющиеся пары остаются на месте.
+    // При исключении хвост может оказаться частично перенесённым, но имеющиеся пары не тронуты,
+    // и InsertUnsorted убирает хвост из обоих столбцов
+    void MergeTail(size_t old_size) {
+        Vector<size_t> order(Size() - old_size);
+        for (size_t i = 0; i < order.Size(); ++i) {
+            order[i] = old_size + i;
+        }
+        const auto less = [this](size_t lhs, size_t rhs) {
+            return comp_(keys_[lhs], keys_[rhs]);
+        };
+        const auto equivalent = [this](size_t lhs, size_t rhs) {
+            return !comp_(keys_[lhs], keys_[rhs]);
+        };
+        std::stable_sort(order.begin(), order.end(), less);
+        if (old_size == 0 || less(old_size - 1, order[0])) {
+            const auto order_end = std::unique(order.begin(), order.end(), equivalent);
+            // Уже упорядоченный хвост без повторов остаётся как есть
+            bool in_place = order_end == order.end();
+            for (size_t i = 0; in_place && i < order.Size(); ++i) {
+                in_place = order[i] == old_size + i;
+            }
+            if (in_place) {
+                return;
+            }
+            Vector<K> keys;
+            Vector<V> values;
+            Gather(order.begin(), order_end, keys, values);
+            keys_.Erase(keys_.begin() + old_size, keys_.end());
+            values_.Erase(values_.begin() + old_size, values_.end());
+            for (K& key : keys) {
+                keys_.PushBack(std::move_if_noexcept(key));
+            }
+            for (V& value : values) {
+                values_.PushBack(std::move_if_noexcept(value));
+            }
+            return;
+        }
+
+        Vector<size_t> merged(Size());
+        for (size_t i = 0; i < old_size; ++i) {
+            merged[i] = i;
+        }
+        std::copy(order.begin(), order.end(), merged.begin() + old_size);
+        std::inplace_merge(merged.begin(), merged.begin() + old_size, merged.end(), less);
+        const auto merged_end = std::unique(merged.begin(), merged.end(), equivalent);
+        Vector<K> keys;
+        Vector<V> values;
+        Gather(merged.begin(), merged_end, keys, values);
+        keys_ = std::move(keys);
+        values_ = std::move(values);
+    }
+
+    // Переносит пары с индексами [first, last) в новые столбцы. Столбец, который может
+    // выбросить исключение при копировании, собирается первым: пока он не готов,
+    // исходные пары не тронуты
+    template <typename OrderIt>
+    void Gather(OrderIt first, OrderIt last, Vector<K>& keys, Vector<V>& values) {
+        const auto count = static_cast<size_t>(last - first);
+        keys.Reserve(count);
+        values.Reserve(count);
+        const auto gather = [first, last](auto& from, auto& to) {
+            for (auto it = first; it != last; ++it) {
+                to.PushBack(std::move_if_noexcept(from[*it]));
+            }
+        };
+        if constexpr (std::is_nothrow_move_constructible_v<K>) {
+            gather(values_, values);
+            gather(keys_, keys);
+        } else {
+            gather(keys_, keys);
+            gather(values_, values);
+        }
+    }
+
+    template <typename Key>
+    size_t LowerBoundIndex(const Key& key) const {
+        if (index_.IsBuiltFor(keys_.Size())) {
+            return index_.LowerBound(key, comp_);
+        }
+        return BranchlessLowerBound(Keys(), key, comp_);
+    }
+
+    template <typename Key>
+    size_t FindIndex(const Key& key) const {
+        const size_t index = LowerBoundIndex(key);
+        return index != Size() && !comp_(key, keys_[index]) ? index : Size();
+    }
+
+    template <typename Key>
+    size_t CheckedIndex(const Key& key) const {
+        const size_t index = FindIndex(key);
+        if (index == Size()) {
+            throw std::out_of_range("FlatMap key not found");
+        }
+        return index;
+    }
+
+    // Если вставка значения не удалась, уже вставленный ключ удаляется
+    void InsertAt(size_t index, K&& key, V&& value) {
+        index_.Clear();
+        keys_.Insert(keys_.begin() + index, std::move(key));
+        try {
+            values_.Insert(values_.begin() + index, std::move(value));
+        } catch (...) {
+            keys_.Erase(keys_.begin() + index);
+            throw;
+        }
+    }
+};
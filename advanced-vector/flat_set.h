@@ -0,0 +1,255 @@
+#pragma once
+
+#include "vector.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <ranges>
+#include <span>
+#include <utility>
+
+// Поиск нижней границы в отсортированном массиве без ветвлений внутри цикла: на каждом шаге
+// выбор половины компилируется в условную пересылку, и конвейер не сбрасывается
+// из-за неверно предсказанных переходов
+template <typename K, typename Key, typename Compare>
+size_t BranchlessLowerBound(std::span<const K> keys, const Key& key, const Compare& comp) {
+    if (keys.empty()) {
+        return 0;
+    }
+    const K* base = keys.data();
+    size_t n = keys.size();
+    while (n > 1) {
+        const size_t half = n / 2;
+        base = comp(base[half], key) ? base + half : base;
+        n -= half;
+    }
+    return static_cast<size_t>(base - keys.data()) + (comp(*base, key) ? 1 : 0);
+}
+
+// Копия отсортированных ключей в порядке Эйтцингера (неявное двоичное дерево в ширину):
+// первые шаги поиска обращаются к нескольким соседним кэш-линиям, а следующие
+// можно запросить заранее. Подходит для таблиц, которые редко изменяются
+template <typename K, typename Compare>
+class EytzingerIndex {
+public:
+    void Build(std::span<const K> keys) {
+        Vector<size_t> ranks(keys.size());
+        size_t rank = 0;
+        FillRanks(ranks, 1, rank);
+        Vector<K> layout;
+        layout.Reserve(keys.size());
+        for (size_t rank_of_node : ranks) {
+            layout.PushBack(keys[rank_of_node]);
+        }
+        layout_ = std::move(layout);
+        ranks_ = std::move(ranks);
+    }
+
+    void Clear() noexcept {
+        layout_ = Vector<K>();
+        ranks_ = Vector<size_t>();
+    }
+
+    // Индекс построен для size ключей
+    bool IsBuiltFor(size_t size) const noexcept {
+        return size != 0 && layout_.Size() == size;
+    }
+
+    // Возвращает позицию нижней границы в отсортированном массиве ключей
+    template <typename Key>
+    size_t LowerBound(const Key& key, const Compare& comp) const {
+        const size_t n = layout_.Size();
+        // Узлы нумеруются с единицы: потомки узла j — 2j и 2j + 1
+        size_t j = 1;
+        while (j <= n) {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_prefetch(layout_.Data() + std::min(16 * j, n) - 1);
+#endif
+            j = 2 * j + (comp(layout_[j - 1], key) ? 1 : 0);
+        }
+        // Последний переход влево ведёт к узлу с нижней границей
+        j >>= std::countr_one(j) + 1;
+        return j == 0 ? n : ranks_[j - 1];
+    }
+
+private:
+    Vector<K> layout_;
+    Vector<size_t> ranks_;  // позиция ключа узла j - 1 в отсортированном массиве
+
+    static void FillRanks(Vector<size_t>& ranks, size_t j, size_t& rank) {
+        if (j > ranks.Size()) {
+            return;
+        }
+        FillRanks(ranks, 2 * j, rank);
+        ranks[j - 1] = rank++;
+        FillRanks(ranks, 2 * j + 1, rank);
+    }
+};
+
+// Упорядоченное множество в непрерывном массиве. Поиск выполняется двоичным поиском
+// без ветвлений или, после BuildSearchIndex, по индексу Эйтцингера. Вставка и удаление
+// сдвигают хвост за O(n), поэтому множество подходит для таблиц, которые в основном читаются
+template <typename K, typename Compare = std::less<K>>
+class FlatSet {
+public:
+    using iterator = const K*;
+    using const_iterator = const K*;
+
+    FlatSet() = default;
+
+    explicit FlatSet(const Compare& comp)
+        : comp_(comp) {
+    }
+
+    FlatSet(std::initializer_list<K> keys, const Compare& comp = Compare())
+        : comp_(comp) {
+        InsertUnsorted(keys);
+    }
+
+    const_iterator begin() const noexcept {
+        return keys_.Data();
+    }
+
+    const_iterator end() const noexcept {
+        return keys_.Data() + keys_.Size();
+    }
+
+    size_t Size() const noexcept {
+        return keys_.Size();
+    }
+
+    void Reserve(size_t capacity) {
+        keys_.Reserve(capacity);
+    }
+
+    void Clear() noexcept {
+        keys_.Clear();
+        index_.Clear();
+    }
+
+    const K& operator[](size_t index) const noexcept {
+        return keys_[index];
+    }
+
+    template <typename Key>
+    const_iterator LowerBound(const Key& key) const {
+        if (index_.IsBuiltFor(keys_.Size())) {
+            return begin() + index_.LowerBound(key, comp_);
+        }
+        return begin() + BranchlessLowerBound(Keys(), key, comp_);
+    }
+
+    template <typename Key>
+    const_iterator Find(const Key& key) const {
+        const const_iterator it = LowerBound(key);
+        return it != end() && !comp_(key, *it) ? it : end();
+    }
+
+    template <typename Key>
+    bool Contains(const Key& key) const {
+        return Find(key) != end();
+    }
+
+    // Возвращает позицию ключа и true, если он был добавлен
+    template <typename Key>
+    std::pair<const_iterator, bool> Insert(Key&& key) {
+        const const_iterator it = LowerBound(key);
+        if (it != end() && !comp_(key, *it)) {
+            return {it, false};
+        }
+        index_.Clear();
+        const auto index = it - begin();
+        keys_.Insert(keys_.begin() + index, K(std::forward<Key>(key)));
+        return {begin() + index, true};
+    }
+
+    template <typename Key>
+        requires(!std::convertible_to<const Key&, const_iterator>)
+    size_t Erase(const Key& key) {
+        const const_iterator it = Find(key);
+        if (it == end()) {
+            return 0;
+        }
+        Erase(it);
+        return 1;
+    }
+
+    const_iterator Erase(const_iterator pos) {
+        index_.Clear();
+        const auto index = pos - begin();
+        keys_.Erase(keys_.begin() + index);
+        return begin() + index;
+    }
+
+    // Добавляет ключи из произвольного диапазона: они дописываются в конец, сортируются
+    // и сливаются с имеющимися за один проход. Из равных ключей остаётся первый,
+    // уже имевшийся в множестве или встретившийся раньше в диапазоне.
+    // Если компаратор или копирование ключа выбросит исключение, множество не изменится
+    template <std::ranges::input_range Range>
+    void InsertUnsorted(Range&& range) {
+        const size_t old_size = keys_.Size();
+        keys_.Append(std::forward<Range>(range));
+        index_.Clear();
+        try {
+            std::stable_sort(keys_.Data() + old_size, keys_.Data() + keys_.Size(), comp_);
+            MergeTail(old_size);
+        } catch (...) {
+            // Дописанные ключи убираются, имеющиеся до этого не тронуты
+            keys_.Erase(keys_.begin() + old_size, keys_.end());
+            throw;
+        }
+    }
+
+    // Строит индекс Эйтцингера для ускорения поиска. Любое изменение множества
+    // сбрасывает индекс, и поиск возвращается к двоичному
+    void BuildSearchIndex() {
+        index_.Build(Keys());
+    }
+
+    std::span<const K> Keys() const noexcept {
+        return {keys_.Data(), keys_.Size()};
+    }
+
+private:
+    Vector<K> keys_;
+    EytzingerIndex<K, Compare> index_;
+    [[no_unique_address]] Compare comp_;
+
+    // Сливает упорядоченный хвост, дописанный после old_size, с имеющимися ключами и убирает
+    // повторы. Если все новые ключи больше имеющихся, переставляется только хвост. Иначе
+    // сливается перестановка индексов, и ключи переносятся по ней в новый буфер: исключение
+    // std::inplace_merge над самими ключами оставило бы часть имеющихся ключей потерянной
+    void MergeTail(size_t old_size) {
+        K* middle = keys_.Data() + old_size;
+        K* last = keys_.Data() + keys_.Size();
+        const auto equivalent = [this](const K& lhs, const K& rhs) {
+            return !comp_(lhs, rhs);
+        };
+        if (middle == last) {
+            return;
+        }
+        if (old_size == 0 || comp_(middle[-1], *middle)) {
+            keys_.Erase(keys_.begin() + (std::unique(middle, last, equivalent) - keys_.Data()), keys_.end());
+            return;
+        }
+        Vector<size_t> order(keys_.Size());
+        for (size_t i = 0; i < order.Size(); ++i) {
+            order[i] = i;
+        }
+        std::inplace_merge(order.begin(), order.begin() + old_size, order.end(), [this](size_t lhs, size_t rhs) {
+            return comp_(keys_[lhs], keys_[rhs]);
+        });
+        const auto order_end = std::unique(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+            return equivalent(keys_[lhs], keys_[rhs]);
+        });
+        Vector<K> keys;
+        keys.Reserve(order_end - order.begin());
+        for (auto it = order.begin(); it != order_end; ++it) {
+            keys.PushBack(std::move_if_noexcept(keys_[*it]));
+        }
+        keys_ = std::move(keys);
+    }
+};
@@ -0,0 +1,248 @@
+#pragma once
+
+#include "vector.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Параметры размещения крупных буферов HugePageAllocator
+struct HugePageOptions {
+    int numa_node = -1;                // узел NUMA, к которому привязывается память; -1 — без привязки
+    bool explicit_huge_pages = false;  // сначала пробовать заранее зарезервированные страницы (MAP_HUGETLB)
+
+    bool operator==(const HugePageOptions&) const = default;
+};
+
+// Число отказов ядра привязать блок к узлу NUMA. Привязка выполняется по возможности,
+// и по этому счётчику отказ можно обнаружить
+inline std::atomic<size_t>& GetHugePageBindFailures() noexcept {
+    static std::atomic<size_t> failures = 0;
+    return failures;
+}
+
+// Аллокатор для больших таблиц. Блоки от ThresholdBytes выделяются через mmap, выравниваются
+// по 2 МБ и помечаются MADV_HUGEPAGE, чтобы ядро отображало их большими страницами и
+// промахов TLB было меньше. Такие блоки можно привязать к узлу NUMA (mbind), тогда
+// память не окажется на чужом сокете при первом обращении. Привязка и явные большие
+// страницы выполняются по возможности: при отказе ядра используется обычное отображение.
+// Небольшие блоки выделяются через malloc. Вне Linux все блоки выделяются через malloc.
+// reallocate позволяет вектору тривиально перемещаемых элементов расти через mremap.
+// Аллокаторы с разными параметрами не равны: блок освобождает и расширяет только аллокатор
+// с теми же параметрами, что его отобразил, поэтому при перемещении и обмене аллокатор
+// переходит вместе с буфером
+template <typename T, size_t ThresholdBytes = size_t{2} << 20>
+class HugePageAllocator {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "HugePageAllocator does not support over-aligned types");
+
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    template <typename U>
+    struct rebind {
+        using other = HugePageAllocator<U, ThresholdBytes>;
+    };
+
+    static constexpr size_t HUGE_PAGE_SIZE = size_t{2} << 20;
+
+    HugePageAllocator() = default;
+
+    explicit HugePageAllocator(HugePageOptions options) noexcept
+        : options_(options) {
+    }
+
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U, ThresholdBytes>& other) noexcept
+        : options_(other.GetOptions()) {
+    }
+
+    T* allocate(size_t n) {
+        const size_t bytes = BytesFor(n);
+        return static_cast<T*>(IsMapped(bytes) ? Map(bytes) : CheckAllocated(std::malloc(bytes)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        const size_t bytes = n * sizeof(T);
+        if (IsMapped(bytes)) {
+            Unmap(p, bytes);
+        } else {
+            std::free(p);
+        }
+    }
+
+    T* reallocate(T* p, size_t old_n, size_t new_n) {
+        const size_t old_bytes = old_n * sizeof(T);
+        const size_t new_bytes = BytesFor(new_n);
+        const bool old_mapped = IsMapped(old_bytes);
+        const bool new_mapped = IsMapped(new_bytes);
+        if (!old_mapped && !new_mapped) {
+            return static_cast<T*>(CheckAllocated(std::realloc(p, new_bytes)));
+        }
+#ifdef __linux__
+        // Явные большие страницы mremap переносит не на всех ядрах, поэтому для них блок копируется
+        if (old_mapped && new_mapped && !options_.explicit_huge_pages) {
+            return static_cast<T*>(Remap(p, MappedLength(old_bytes), MappedLength(new_bytes)));
+        }
+#endif
+        T* result = allocate(new_n);
+        std::memcpy(static_cast<void*>(result), static_cast<const void*>(p), std::min(old_bytes, new_bytes));
+        deallocate(p, old_n);
+        return result;
+    }
+
+    HugePageOptions GetOptions() const noexcept {
+        return options_;
+    }
+
+    friend bool operator==(const HugePageAllocator& lhs, const HugePageAllocator& rhs) noexcept {
+        return lhs.options_ == rhs.options_;
+    }
+
+private:
+    HugePageOptions options_;
+
+    static bool IsMapped(size_t bytes) noexcept {
+#ifdef __linux__
+        return bytes >= ThresholdBytes && bytes != 0;
+#else
+        (void)bytes;
+        return false;
+#endif
+    }
+
+    static size_t MappedLength(size_t bytes) noexcept {
+        return (bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    }
+
+    static size_t BytesFor(size_t n) {
+        if (n > (std::numeric_limits<size_t>::max() - HUGE_PAGE_SIZE) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return n * sizeof(T);
+    }
+
+    static void* CheckAllocated(void* p) {
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+
+#ifdef __linux__
+    void* Map(size_t bytes) const {
+        const size_t length = MappedLength(bytes);
+        void* p = MAP_FAILED;
+#ifdef MAP_HUGETLB
+        if (options_.explicit_huge_pages) {
+            p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        }
+#endif
+        if (p == MAP_FAILED) {
+            p = MapAligned(length);
+#ifdef MADV_HUGEPAGE
+            madvise(p, length, MADV_HUGEPAGE);
+#endif
+        }
+        BindToNode(p, length);
+        return p;
+    }
+
+    // Переносит отображение на новую длину, сохраняя выравнивание по HUGE_PAGE_SIZE: сначала
+    // пробует расширить его на месте, иначе перемещает в заранее выровненную область.
+    // MREMAP_MAYMOVE без MREMAP_FIXED выбирает адрес, кратный лишь размеру обычной страницы
+    void* Remap(void* p, size_t old_length, size_t new_length) const {
+        if (old_length == new_length) {
+            return p;
+        }
+        void* result = mremap(p, old_length, new_length, 0);
+        if (result == MAP_FAILED) {
+            void* target = MapAligned(new_length);
+            result = mremap(p, old_length, new_length, MREMAP_MAYMOVE | MREMAP_FIXED, target);
+            if (result == MAP_FAILED) {
+                munmap(target, new_length);
+                throw std::bad_alloc();
+            }
+        }
+        // Политика и привязка новой области не наследуются от прежнего отображения
+#ifdef MADV_HUGEPAGE
+        madvise(result, new_length, MADV_HUGEPAGE);
+#endif
+        BindToNode(result, new_length);
+        return result;
+    }
+
+    // Отображает length байт с адреса, кратного HUGE_PAGE_SIZE: лишнее по краям освобождается
+    static void* MapAligned(size_t length) {
+        const size_t padded = length + HUGE_PAGE_SIZE;
+        void* raw = mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        const auto begin = reinterpret_cast<std::uintptr_t>(raw);
+        const auto aligned = (begin + HUGE_PAGE_SIZE - 1) & ~(std::uintptr_t{HUGE_PAGE_SIZE} - 1);
+        if (aligned != begin) {
+            munmap(raw, aligned - begin);
+        }
+        const size_t tail = begin + padded - (aligned + length);
+        if (tail != 0) {
+            munmap(reinterpret_cast<void*>(aligned + length), tail);
+        }
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    void BindToNode(void* p, size_t length) const noexcept {
+#ifdef SYS_mbind
+        constexpr int NODE_BITS = std::numeric_limits<unsigned long>::digits;
+        if (options_.numa_node < 0) {
+            return;
+        }
+        if (options_.numa_node >= NODE_BITS) {
+            GetHugePageBindFailures().fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        // MPOL_BIND из <numaif.h>, заголовок libnuma для одного вызова не нужен.
+        // Ядро читает maxnode - 1 бит маски, поэтому передаётся NODE_BITS + 1
+        constexpr int MPOL_BIND_MODE = 2;
+        const unsigned long node_mask = 1UL << options_.numa_node;
+        if (syscall(SYS_mbind, p, length, MPOL_BIND_MODE, &node_mask, NODE_BITS + 1, 0) != 0) {
+            GetHugePageBindFailures().fetch_add(1, std::memory_order_relaxed);
+        }
+#else
+        (void)p;
+        (void)length;
+#endif
+    }
+
+    static void Unmap(void* p, size_t bytes) noexcept {
+        munmap(p, MappedLength(bytes));
+    }
+#else
+    void* Map(size_t bytes) const {
+        return CheckAllocated(std::malloc(bytes));
+    }
+
+    static void Unmap(void* p, size_t /*bytes*/) noexcept {
+        std::free(p);
+    }
+#endif
+};
+
+// Вектор для больших таблиц; узел NUMA задаётся через аллокатор:
+// HugePageVector<float> v(HugePageAllocator<float>(HugePageOptions{.numa_node = 1}))
+template <typename T, typename GrowthPolicy = DoublingGrowth<>>
+using HugePageVector = Vector<T, HugePageAllocator<T>, GrowthPolicy>;
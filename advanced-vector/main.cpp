@@ -1,10 +1,50 @@
+// Тесты проверяют и сбор статистики, поэтому он включается до подключения заголовка
+#define VECTOR_ENABLE_STATS
+// По умолчанию тесты собираются с полными проверками; -DVECTOR_CHECK_LEVEL=0 проверяет сборку без них
+#ifndef VECTOR_CHECK_LEVEL
+#define VECTOR_CHECK_LEVEL 2
+#endif
 #include "vector.h"
+#include "concurrent_vector.h"
+#include "cow_vector.h"
+#include "flat_map.h"
+#include "flat_set.h"
+#include "huge_page_allocator.h"
+#include "mapped_vector.h"
+#include "parallel.h"
+#include "segmented_vector.h"
+#include "vector_io.h"
+#include "vector_pool.h"
+#include "soa_vector.h"
+#include "static_vector.h"
 
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <ctime>
 #include <iostream>
+#include <iterator>
+#include <memory_resource>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
+#if defined(__unix__)
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 namespace {
 
 // "Магическое" число, используемое для отслеживания живости объекта
@@ -116,8 +156,85 @@ struct Obj {
     static inline int num_move_assigned = 0;
 };
 
+// Obj для тестов с несколькими потоками: счётчики Obj не атомарны
+struct AtomicObj {
+    AtomicObj() {
+        if (throw_countdown.fetch_sub(1) == 1) {
+            throw std::runtime_error("Oops");
+        }
+        ++alive;
+    }
+    AtomicObj(const AtomicObj& other)
+        : id(other.id) {
+        if (throw_countdown.fetch_sub(1) == 1) {
+            throw std::runtime_error("Oops");
+        }
+        ++alive;
+    }
+    AtomicObj(AtomicObj&& other) noexcept
+        : id(other.id) {
+        ++alive;
+    }
+    AtomicObj& operator=(const AtomicObj&) = default;
+    ~AtomicObj() {
+        --alive;
+    }
+
+    int id = 7;
+    static inline std::atomic<int> alive = 0;
+    static inline std::atomic<int> throw_countdown = 0;
+};
+
+// Нетривиальный тип, явно объявленный тривиально перемещаемым
+struct RelocatableObj {
+    RelocatableObj() = default;
+    RelocatableObj(const RelocatableObj& other)
+        : id(other.id) {
+        ++num_copied;
+    }
+    RelocatableObj(RelocatableObj&& other) noexcept
+        : id(other.id) {
+        ++num_moved;
+    }
+    RelocatableObj& operator=(const RelocatableObj& other) = default;
+    RelocatableObj& operator=(RelocatableObj&& other) = default;
+    ~RelocatableObj() {
+        ++num_destroyed;
+    }
+
+    static void ResetCounters() {
+        num_copied = 0;
+        num_moved = 0;
+        num_destroyed = 0;
+    }
+
+    int id = 0;
+
+    static inline int num_copied = 0;
+    static inline int num_moved = 0;
+    static inline int num_destroyed = 0;
+};
+
 }  // namespace
 
+template <>
+struct IsTriviallyRelocatable<RelocatableObj> : std::true_type {};
+
+template <>
+struct VectorSerializer<Obj> {
+    static void Write(std::ostream& out, const Obj& value) {
+        VectorSerializer<std::string>::Write(out, value.name);
+        out.write(reinterpret_cast<const char*>(&value.id), sizeof(value.id));
+    }
+
+    static Obj Read(std::istream& in) {
+        std::string name = VectorSerializer<std::string>::Read(in);
+        int id = 0;
+        in.read(reinterpret_cast<char*>(&id), sizeof(id));
+        return Obj(id, std::move(name));
+    }
+};
+
 void Test1() {
     Obj::ResetCounters();
     const size_t SIZE = 100500;
@@ -432,7 +549,7 @@ void Test6() {
     {
         Obj::ResetCounters();
         Vector<Obj> v;
-        auto* pos = v.Emplace(v.end(), Obj{1});
+        auto pos = v.Emplace(v.end(), Obj{1});
         assert(v.Size() == 1);
         assert(v.Capacity() >= v.Size());
         assert(&*pos == &v[0]);
@@ -447,7 +564,7 @@ void Test6() {
         Obj::ResetCounters();
         Vector<Obj> v;
         v.Reserve(SIZE);
-        auto* pos = v.Emplace(v.end(), Obj{1});
+        auto pos = v.Emplace(v.end(), Obj{1});
         assert(v.Size() == 1);
         assert(v.Capacity() >= v.Size());
         assert(&*pos == &v[0]);
@@ -494,7 +611,7 @@ void Test6() {
     {
         Obj::ResetCounters();
         Vector<Obj> v{SIZE};
-        auto* pos = v.Emplace(v.cbegin() + 1, ID, "Ivan"s);
+        auto pos = v.Emplace(v.cbegin() + 1, ID, "Ivan"s);
         assert(v.Size() == SIZE + 1);
         assert(v.Capacity() == SIZE * 2);
         assert(&*pos == &v[1]);
@@ -510,7 +627,7 @@ void Test6() {
     {
         Obj::ResetCounters();
         Vector<Obj> v{SIZE};
-        auto* pos = v.Emplace(v.cbegin() + v.Size(), ID, "Ivan"s);
+        auto pos = v.Emplace(v.cbegin() + v.Size(), ID, "Ivan"s);
         assert(v.Size() == SIZE + 1);
         assert(v.Capacity() == SIZE * 2);
         assert(&*pos == &v[SIZE]);
@@ -529,7 +646,7 @@ void Test6() {
         v.Reserve(SIZE * 2);
         const int old_num_moved = Obj::num_moved;
         assert(v.Capacity() == SIZE * 2);
-        auto* pos = v.Emplace(v.cbegin() + 3, ID, "Ivan"s);
+        auto pos = v.Emplace(v.cbegin() + 3, ID, "Ivan"s);
         assert(v.Size() == SIZE + 1);
         assert(&*pos == &v[3]);
         assert(v[3].id == ID);
@@ -545,7 +662,7 @@ void Test6() {
         Obj::ResetCounters();
         Vector<Obj> v{SIZE};
         v[2].id = ID;
-        auto* pos = v.Erase(v.cbegin() + 1);
+        auto pos = v.Erase(v.cbegin() + 1);
         assert((pos - v.begin()) == 1);
         assert(v.Size() == SIZE - 1);
         assert(v.Capacity() == SIZE);
@@ -558,84 +675,1972 @@ void Test6() {
     }
 }
 
-struct C {
-    C() noexcept {
-        ++def_ctor;
+void Test7() {
+    const size_t SIZE = 100;
+    const int ID = 42;
+    {
+        alignas(Obj) std::byte buffer[SIZE * sizeof(Obj) * 5];
+        std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+        Obj::ResetCounters();
+        {
+            pmr::Vector<Obj> v(SIZE, &arena);
+            v[SIZE - 1].id = ID;
+            v.PushBack(Obj{ID});
+            assert(v.Size() == SIZE + 1);
+            assert(v.GetAllocator().resource() == &arena);
+            assert(reinterpret_cast<std::byte*>(&v[0]) >= buffer);
+            assert(reinterpret_cast<std::byte*>(&v[SIZE]) < buffer + sizeof(buffer));
+
+            // Копия получает ресурс по умолчанию (select_on_container_copy_construction)
+            pmr::Vector<Obj> v_copy(v);
+            assert(v_copy.GetAllocator().resource() == std::pmr::get_default_resource());
+            assert(v_copy[SIZE - 1].id == ID);
+
+            // При копирующем присваивании вектор сохраняет свой ресурс
+            pmr::Vector<Obj> v_assigned(&arena);
+            v_assigned = v_copy;
+            assert(v_assigned.GetAllocator().resource() == &arena);
+            assert(v_assigned[SIZE - 1].id == ID);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
     }
-    C(const C& /*other*/) noexcept {
-        ++copy_ctor;
+    {
+        std::pmr::unsynchronized_pool_resource pool1;
+        std::pmr::unsynchronized_pool_resource pool2;
+        Obj::ResetCounters();
+        {
+            pmr::Vector<Obj> v1(SIZE, &pool1);
+            pmr::Vector<Obj> v2(&pool2);
+            v1[0].id = ID;
+            // Аллокаторы не равны и не распространяются: память v1 не может перейти к v2
+            v2 = std::move(v1);
+            assert(v2.GetAllocator().resource() == &pool2);
+            assert(v2.Size() == SIZE);
+            assert(v2[0].id == ID);
+            assert(v1.Size() == 0);
+            assert(Obj::num_moved == static_cast<int>(SIZE));
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
     }
-    C(C&& /*other*/) noexcept {
-        ++move_ctor;
+}
+
+void Test8() {
+    const size_t SIZE = 1000;
+    const int ID = 42;
+    static_assert(IsTriviallyRelocatableV<int>);
+    static_assert(IsTriviallyRelocatableV<std::unique_ptr<int>>);
+    static_assert(!IsTriviallyRelocatableV<Obj>);
+    {
+        RelocatableObj::ResetCounters();
+        Vector<RelocatableObj> v(SIZE);
+        v[SIZE - 1].id = ID;
+        v.Reserve(SIZE * 2);
+        assert(v[SIZE - 1].id == ID);
+        v.Resize(SIZE * 2);
+        v.EmplaceBack();
+        v.PushBack(RelocatableObj{});
+        // Перенос в новый буфер не вызывает ни конструкторов, ни деструкторов
+        assert(RelocatableObj::num_copied == 0);
+        assert(RelocatableObj::num_moved == 1);
+        assert(RelocatableObj::num_destroyed == 1);
+        assert(v[SIZE - 1].id == ID);
     }
-    C& operator=(const C& other) noexcept {
-        if (this != &other) {
-            ++copy_assign;
+    assert(RelocatableObj::num_destroyed == static_cast<int>(SIZE * 2 + 3));
+    {
+        Vector<std::unique_ptr<int>> v;
+        for (int i = 0; i < static_cast<int>(SIZE); ++i) {
+            v.PushBack(std::make_unique<int>(i));
         }
-        return *this;
+        v.Emplace(v.cbegin(), std::make_unique<int>(-1));
+        assert(*v[0] == -1);
+        assert(*v[SIZE] == static_cast<int>(SIZE) - 1);
     }
-    C& operator=(C&& /*other*/) noexcept {
-        ++move_assign;
-        return *this;
+}
+
+void Test9() {
+    const int SIZE = 100'000;
+    {
+        Vector<int, MallocAllocator<int>> v;
+        for (int i = 0; i < SIZE; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.Size() == static_cast<size_t>(SIZE));
+        v.Reserve(SIZE * 4);
+        assert(v.Capacity() == static_cast<size_t>(SIZE * 4));
+        for (int i = 0; i < SIZE; ++i) {
+            assert(v[i] == i);
+        }
     }
-    ~C() {
-        ++dtor;
+    {
+        Vector<int, MallocAllocator<int>> v(10);
+        for (size_t i = 0; i < v.Size(); ++i) {
+            v[i] = static_cast<int>(i);
+        }
+        // Вставка в середину полного вектора с аргументом, ссылающимся на его же элемент
+        v.Insert(v.cbegin() + 3, v[9]);
+        assert(v.Size() == 11);
+        assert(v.Capacity() == 20);
+        assert(v[2] == 2 && v[3] == 9 && v[4] == 3 && v[10] == 9);
+        v.Resize(20);
+        v.PushBack(v[0]);
+        assert(v[20] == 0);
     }
+}
 
-    static void Reset() {
-        def_ctor = 0;
-        copy_ctor = 0;
-        move_ctor = 0;
-        copy_assign = 0;
-        move_assign = 0;
-        dtor = 0;
+template <typename GrowthPolicy>
+std::vector<size_t> CapacitySequence(size_t count) {
+    Vector<int, std::allocator<int>, GrowthPolicy> v;
+    std::vector<size_t> capacities;
+    for (size_t i = 0; i < count; ++i) {
+        v.PushBack(static_cast<int>(i));
+        if (capacities.empty() || capacities.back() != v.Capacity()) {
+            capacities.push_back(v.Capacity());
+        }
     }
+    return capacities;
+}
 
-    inline static size_t def_ctor = 0;
-    inline static size_t copy_ctor = 0;
-    inline static size_t move_ctor = 0;
-    inline static size_t copy_assign = 0;
-    inline static size_t move_assign = 0;
-    inline static size_t dtor = 0;
-};
+void Test10() {
+    using Sizes = std::vector<size_t>;
+    assert(CapacitySequence<DoublingGrowth<>>(9) == (Sizes{1, 2, 4, 8, 16}));
+    assert(CapacitySequence<DoublingGrowth<16>>(33) == (Sizes{16, 32, 64}));
+    assert(CapacitySequence<OneAndHalfGrowth<>>(10) == (Sizes{1, 2, 3, 5, 8, 12}));
+    assert(CapacitySequence<SizeClassGrowth<>>(9) == (Sizes{1, 2, 4, 8, 16}));
+    assert(CapacitySequence<SizeClassGrowth<3>>(5) == (Sizes{4, 8}));
+    assert(SizeClassGrowth<>::NextCapacity(1000, sizeof(int)) == 2048);
+    assert(SizeClassGrowth<>::NextCapacity(1500, 1) == 4096);
+    assert(SizeClassGrowth<>::NextCapacity(3000, 1) == 8192);
+    assert(CapacitySequence<CappedIncrementGrowth<4 * sizeof(int)>>(13) == (Sizes{1, 2, 4, 8, 12, 16}));
+    {
+        Vector<Obj, std::allocator<Obj>, OneAndHalfGrowth<4>> v;
+        Obj::ResetCounters();
+        for (int i = 0; i < 10; ++i) {
+            v.EmplaceBack(i);
+        }
+        assert(v.Capacity() == 14);
+        assert(v[9].id == 9);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
 
-void Dump() {
-    using namespace std;
-    cerr << "Def ctors: "sv << C::def_ctor              //
-         << ", Copy ctors: "sv << C::copy_ctor          //
-         << ", Move ctors: "sv << C::move_ctor          //
-         << ", Copy assignments: "sv << C::copy_assign  //
-         << ", Move assignments: "sv << C::move_assign  //
-         << ", Dtors: "sv << C::dtor << endl;
+template <typename V>
+bool IsStoredInside(const V& v) {
+    const auto* object = reinterpret_cast<const std::byte*>(&v);
+    const auto* element = reinterpret_cast<const std::byte*>(v.Data());
+    return element >= object && element < object + sizeof(v);
 }
 
-void Benchmark() {
-    using namespace std;
-    try {
-        const size_t NUM = 10;
-        C c;
+void Test11() {
+    const size_t N = 4;
+    const int ID = 42;
+    {
+        SmallVector<int, 8> v;
+        assert(v.Capacity() == 8);
+        for (int i = 0; i < 8; ++i) {
+            v.PushBack(i);
+        }
+        assert(IsStoredInside(v));
+        v.PushBack(8);
+        assert(!IsStoredInside(v));
+        assert(v.Capacity() == 16);
+        for (int i = 0; i < 9; ++i) {
+            assert(v[i] == i);
+        }
+    }
+    {
+        Obj::ResetCounters();
         {
-            cerr << "std::vector:"sv << endl;
-            C::Reset();
-            vector<C> v(NUM);
-            Dump();
-            v.push_back(c);
+            SmallVector<Obj, N> v(N);
+            v[N - 1].id = ID;
+            assert(IsStoredInside(v));
+            SmallVector<Obj, N> moved(std::move(v));
+            assert(IsStoredInside(moved));
+            assert(v.Size() == 0);
+            assert(moved[N - 1].id == ID);
+            assert(Obj::num_moved == static_cast<int>(N));
+
+            moved.Emplace(moved.cbegin() + 1, ID);
+            assert(!IsStoredInside(moved));
+            assert(moved.Size() == N + 1);
+            assert(moved[1].id == ID && moved[N].id == ID);
+            const int old_num_moved = Obj::num_moved;
+            SmallVector<Obj, N> stolen(std::move(moved));
+            assert(Obj::num_moved == old_num_moved);
+            assert(stolen.Size() == N + 1);
+            assert(moved.Size() == 0 && moved.Capacity() == N);
+
+            SmallVector<Obj, N> small(2);
+            small.Swap(stolen);
+            assert(small.Size() == N + 1 && !IsStoredInside(small));
+            assert(stolen.Size() == 2 && IsStoredInside(stolen));
+            assert(small[N].id == ID);
+
+            stolen = small;
+            assert(stolen.Size() == N + 1);
+            assert(stolen[1].id == ID);
+            stolen.Erase(stolen.cbegin());
+            assert(stolen[0].id == ID);
+            assert(Obj::GetAliveObjectCount() == static_cast<int>(N + 1 + N));
         }
-        Dump();
-    } catch (...) {
+        assert(Obj::GetAliveObjectCount() == 0);
     }
-    try {
-        const size_t NUM = 10;
-        C c;
+    {
+        Obj::ResetCounters();
+        SmallVector<Obj, N> v(N);
+        v[N - 1].throw_on_copy = true;
+        v.Reserve(N * 2);
+        // Obj перемещается без исключений, поэтому копирование не требуется
+        assert(Obj::num_copied == 0);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(N));
+    }
+    {
+        using namespace std::literals;
+        SmallVector<std::string, 2> v;
+        v.PushBack("first"s);
+        SmallVector<std::string, 2> other;
+        other.PushBack("a"s);
+        other.PushBack("b"s);
+        other.PushBack("c"s);
+        other = std::move(v);
+        assert(other.Size() == 1 && other[0] == "first"s);
+        assert(IsStoredInside(other));
+    }
+}
+
+void Test12() {
+    using namespace std::literals;
+    const size_t SIZE = 10;
+    const int ID = 42;
+    {
+        Vector<int> v{1, 2, 3};
+        assert(v.Size() == 3 && v.Capacity() == 3);
+        const std::vector<int> source{10, 11, 12, 13};
+        auto pos = v.Insert(v.cbegin() + 1, source.begin(), source.end());
+        assert(pos == v.begin() + 1);
+        assert(v.Capacity() == 7);
+        assert((std::vector<int>(v.begin(), v.end()) == std::vector<int>{1, 10, 11, 12, 13, 2, 3}));
+        v.Reserve(20);
+        v.Insert(v.cbegin(), 2, v[6]);
+        assert((std::vector<int>(v.begin(), v.end()) == std::vector<int>{3, 3, 1, 10, 11, 12, 13, 2, 3}));
+        v.Insert(v.cend(), {7, 8});
+        v.Append(std::vector<int>{9});
+        assert(v.Size() == 12 && v[10] == 8 && v[11] == 9);
+        assert(v.Capacity() == 20);
+    }
+    {
+        std::istringstream input("4 5 6");
+        Vector<int> v{1, 2};
+        v.Insert(v.cbegin() + 1, std::istream_iterator<int>(input), std::istream_iterator<int>());
+        assert((std::vector<int>(v.begin(), v.end()) == std::vector<int>{1, 4, 5, 6, 2}));
+    }
+    {
+        // Диапазоны с концом другого типа и итераторами, не являющимися итераторами C++17
+        Vector<int> v{1};
+        v.Append(std::views::iota(10) | std::views::take(3));
+        v.Append(std::views::iota(0, 3) | std::views::transform([](int i) {
+                     return i * i;
+                 }));
+        std::istringstream input("7 8 9");
+        v.Append(std::views::istream<int>(input) | std::views::take(2));
+        assert((std::vector<int>(v.begin(), v.end()) == std::vector<int>{1, 10, 11, 12, 0, 1, 4, 7, 8}));
+        Vector<std::string> names;
+        names.Append(std::views::iota(0) | std::views::take(SIZE) | std::views::transform([](int i) {
+                         return std::to_string(i);
+                     }));
+        assert(names.Size() == SIZE && names[SIZE - 1] == "9");
+    }
+    {
+        // Однопроходный итератор, как у потока, поверх массива Obj
+        struct SinglePass {
+            using value_type = Obj;
+            using difference_type = std::ptrdiff_t;
+
+            const Obj* ptr = nullptr;
+
+            const Obj& operator*() const {
+                return *ptr;
+            }
+            SinglePass& operator++() {
+                ++ptr;
+                return *this;
+            }
+            void operator++(int) {
+                ++ptr;
+            }
+            bool operator==(const SinglePass&) const = default;
+        };
+        static_assert(std::input_iterator<SinglePass> && !std::forward_iterator<SinglePass>);
+
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        v[0].id = ID;
+        v.Reserve(SIZE + 2);
+        Vector<Obj> source(SIZE);
+        source[SIZE / 2].throw_on_copy = true;
+        try {
+            v.Insert(v.cbegin() + 1, SinglePass{source.Data()}, SinglePass{source.Data() + SIZE});
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        // Добавленные до исключения элементы удалены, старые остались на месте
+        assert(v.Size() == SIZE && v[0].id == ID);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE * 2));
+    }
+    {
+        Obj::ResetCounters();
         {
-            cerr << "Vector:"sv << endl;
-            C::Reset();
-            Vector<C> v(NUM);
-            Dump();
-            v.PushBack(c);
+            Vector<Obj> v(SIZE);
+            v[SIZE - 1].id = ID;
+            v.Insert(v.cbegin() + 2, SIZE, Obj{ID});
+            assert(v.Size() == SIZE * 2);
+            assert(v.Capacity() == SIZE * 2);
+            assert(v[2].id == ID && v[SIZE + 1].id == ID && v[SIZE + 2].id == 0 && v[SIZE * 2 - 1].id == ID);
+            // Каждый старый элемент перенесён в новый буфер ровно один раз
+            assert(Obj::num_moved == static_cast<int>(SIZE));
+            assert(Obj::num_copied == static_cast<int>(SIZE));
+            assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE * 2));
+
+            Vector<Obj> copy(v.begin() + SIZE, v.end());
+            assert(copy.Size() == SIZE && copy.Capacity() == SIZE);
+            assert(copy[SIZE - 1].id == ID);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        Vector<Obj> source(SIZE);
+        source[SIZE / 2].throw_on_copy = true;
+        try {
+            v.Insert(v.cbegin() + 1, source.begin(), source.end());
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == SIZE && v.Capacity() == SIZE);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE * 2));
+    }
+    {
+        Vector<std::string> v{"a"s, "d"s};
+        v.Reserve(10);
+        v.Insert(v.cbegin() + 1, {"b"s, "c"s});
+        assert((std::vector<std::string>(v.begin(), v.end()) == std::vector<std::string>{"a"s, "b"s, "c"s, "d"s}));
+    }
+}
+
+void Test13() {
+    using namespace std::literals;
+    const size_t SIZE = 10;
+    {
+        Vector<int> v{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+        auto pos = v.Erase(v.cbegin() + 2, v.cbegin() + 5);
+        assert(*pos == 5);
+        assert((std::vector<int>(v.begin(), v.end()) == std::vector<int>{0, 1, 5, 6, 7, 8, 9}));
+        assert(v.Capacity() == SIZE);
+        assert(EraseIf(v, [](int x) {
+                   return x % 2 != 0;
+               }) == 4);
+        assert((std::vector<int>(v.begin(), v.end()) == std::vector<int>{0, 6, 8}));
+        v.Erase(v.cbegin(), v.cend());
+        assert(v.Size() == 0);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v[i].id = static_cast<int>(i);
+        }
+        auto pos = v.Erase(v.cbegin() + 1, v.cbegin() + 4);
+        assert(pos->id == 4);
+        assert(Obj::num_move_assigned == static_cast<int>(SIZE - 4));
+        assert(Obj::num_destroyed == 3);
+        assert(EraseIf(v, [](const Obj& obj) {
+                   return obj.id > 5;
+               }) == 4);
+        assert(v.Size() == 3 && v[0].id == 0 && v[1].id == 4 && v[2].id == 5);
+        assert(Obj::GetAliveObjectCount() == 3);
+    }
+    {
+        // Пустой диапазон не затрагивает элементы
+        Vector<std::string> v{"a"s, "b"s, "c"s, "d"s, "e"s};
+        auto pos = v.Erase(v.cbegin() + 1, v.cbegin() + 1);
+        assert(*pos == "b"s);
+        assert((std::vector<std::string>(v.begin(), v.end()) == std::vector<std::string>{"a"s, "b"s, "c"s, "d"s, "e"s}));
+        SmallVector<std::string, 4> small{"a"s, "b"s};
+        small.Erase(small.cbegin(), small.cbegin());
+        assert(small.Size() == 2 && small[0] == "a"s && small[1] == "b"s);
+        Vector<int> empty;
+        empty.Erase(empty.cbegin(), empty.cend());
+        assert(empty.Size() == 0);
+    }
+}
+
+void Test14() {
+    const size_t SIZE = 100;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE, default_init);
+        assert(v.Size() == SIZE);
+        assert(Obj::num_default_constructed == static_cast<int>(SIZE));
+        v.ResizeDefaultInit(SIZE * 2);
+        assert(Obj::num_default_constructed == static_cast<int>(SIZE * 2));
+        v.ResizeDefaultInit(SIZE / 2);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE / 2));
+    }
+    {
+        Vector<int> v{1, 2, 3};
+        v.ResizeAndOverwrite(SIZE, [](int* data, size_t count) {
+            assert(data[0] == 1 && data[2] == 3);
+            for (size_t i = 3; i < count / 2; ++i) {
+                data[i] = static_cast<int>(i) + 1;
+            }
+            return count / 2;
+        });
+        assert(v.Size() == SIZE / 2);
+        assert(v.Capacity() == SIZE);
+        for (size_t i = 0; i < v.Size(); ++i) {
+            assert(v[i] == static_cast<int>(i) + 1);
+        }
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        v.ResizeAndOverwrite(SIZE * 2, [](Obj* data, size_t count) {
+            data[count - 1].id = 1;
+            return count - 1;
+        });
+        assert(v.Size() == SIZE * 2 - 1);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE * 2 - 1));
+    }
+}
+
+void Test15() {
+    const size_t SIZE = 100;
+    const int ID = 42;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        v.Reserve(SIZE * 4);
+        v[SIZE - 1].id = ID;
+        v.ShrinkTo(SIZE * 2);
+        assert(v.Capacity() == SIZE * 2);
+        v.ShrinkToFit();
+        assert(v.Capacity() == SIZE && v.Size() == SIZE);
+        assert(v[SIZE - 1].id == ID);
+        assert(Obj::num_copied == 0);
+        assert(Obj::num_moved == static_cast<int>(SIZE * 3));
+        v.ShrinkTo(1);
+        assert(v.Capacity() == SIZE);
+        v.Clear();
+        assert(v.Size() == 0 && v.Capacity() == SIZE);
+        assert(Obj::GetAliveObjectCount() == 0);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 0);
+    }
+    {
+        Vector<int, MallocAllocator<int>> v(SIZE);
+        v.Reserve(SIZE * 2);
+        v[SIZE - 1] = ID;
+        v.ShrinkToFit();
+        assert(v.Capacity() == SIZE && v[SIZE - 1] == ID);
+    }
+    {
+        SmallVector<std::string, 4> v(SIZE);
+        v[1] = "x";
+        v.Resize(2);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 4 && IsStoredInside(v));
+        assert(v[1] == "x");
+    }
+}
+
+void Test16() {
+    const size_t SIZE = 10;
+    static_assert(VECTOR_STATS_ENABLED);
+    VectorStats<Obj>::Reset();
+    VectorStats<int>::Reset();
+    {
+        Vector<Obj> v;
+        v.Reserve(SIZE);
+        v.Resize(SIZE);
+        v.PushBack(Obj{});
+        v.Reserve(SIZE * 4);
+        v.PopBack();
+        const VectorStatsSnapshot stats = VectorStats<Obj>::Snapshot();
+        assert(stats.reallocations == 3);
+        assert(stats.bytes_allocated == (SIZE + SIZE * 2 + SIZE * 4) * sizeof(Obj));
+        assert(stats.relocated_by_move == SIZE + SIZE + 1);
+        assert(stats.relocated_by_copy == 0);
+        assert(stats.relocated_by_memcpy == 0);
+        assert(stats.peak_capacity == SIZE * 4);
+        assert(stats.wasted_capacity == SIZE * 2 - (SIZE + 1));
+    }
+    assert(VectorStats<Obj>::Snapshot().wasted_capacity == SIZE * 2 - (SIZE + 1) + SIZE * 4 - SIZE);
+    {
+        Vector<int> v(SIZE);
+        v.PushBack(1);
+        assert(VectorStats<int>::Snapshot().relocated_by_memcpy == SIZE);
+    }
+    bool found = false;
+    VectorStatsRegistry::ForEach([&found](std::string_view type_name, const VectorStatsSnapshot& stats) {
+        if (type_name == typeid(int).name()) {
+            found = true;
+            assert(stats.reallocations == 1);
+        }
+    });
+    assert(found);
+}
+
+void Test17() {
+    const size_t SIZE = 100;
+    const int ID = 42;
+    {
+        Vector<int> source(SIZE);
+        source[SIZE - 1] = ID;
+        Vector<int> v(SIZE / 2);
+        v = source;
+        assert(v.Size() == SIZE && v.Capacity() == SIZE && v[SIZE - 1] == ID);
+        Vector<int> small{1, 2, 3};
+        v = small;
+        assert(v.Size() == 3 && v.Capacity() == SIZE && v[2] == 3);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> source(SIZE);
+        Vector<Obj> v(SIZE / 2);
+        v = source;
+        // Старые элементы уничтожены, а не скопированы во временный вектор
+        assert(Obj::num_copied == static_cast<int>(SIZE));
+        assert(Obj::num_assigned == 0);
+        assert(Obj::num_destroyed == static_cast<int>(SIZE / 2));
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE * 2));
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> source(SIZE);
+        source[SIZE / 2].throw_on_copy = true;
+        Vector<Obj> v(SIZE / 2);
+        v[0].id = ID;
+        try {
+            v = source;
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == SIZE / 2 && v[0].id == ID);
+        assert(Obj::GetAliveObjectCount() == static_cast<int>(SIZE + SIZE / 2));
+    }
+}
+
+void Test18() {
+    const size_t ALIGNMENT = 64;
+    const size_t LANES = ALIGNMENT / sizeof(float);
+    auto is_aligned = [](const float* p) {
+        return reinterpret_cast<std::uintptr_t>(p) % ALIGNMENT == 0;
+    };
+    {
+        AlignedVector<float, ALIGNMENT> v;
+        for (size_t i = 0; i < 100; ++i) {
+            v.PushBack(static_cast<float>(i));
+            assert(is_aligned(&v[0]) && v.Capacity() % LANES == 0);
+        }
+        assert(v[99] == 99.0f);
+        v.ShrinkToFit();
+        assert(is_aligned(&v[0]) && v.Capacity() == 112);
+    }
+    {
+        AlignedVector<float, ALIGNMENT> v(5);
+        assert(v.Size() == 5 && v.Capacity() == LANES && is_aligned(&v[0]));
+        v.Reserve(17);
+        assert(v.Capacity() == 2 * LANES && is_aligned(&v[0]));
+        AlignedVector<float, ALIGNMENT> copy(v);
+        assert(copy.Capacity() == LANES && is_aligned(&copy[0]));
+    }
+    {
+        AlignedVector<float, ALIGNMENT, false> v(5);
+        assert(v.Capacity() == 5 && is_aligned(&v[0]));
+    }
+    {
+        // Элементы крупнее выравнивания дополнять не нужно
+        struct alignas(128) Block {
+            char data[128];
+        };
+        AlignedVector<Block, 128> v(3);
+        assert(v.Capacity() == 3 && reinterpret_cast<std::uintptr_t>(v.Data()) % 128 == 0);
+    }
+}
+
+void Test19() {
+    using namespace std::literals;
+    const size_t SIZE = 10;
+    {
+        SoAVector<float, int, std::string> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(static_cast<float>(i), static_cast<int>(i) * 2, std::to_string(i));
+        }
+        assert(v.Size() == SIZE && v.Capacity() >= SIZE);
+        const std::span<float> xs = v.Column<0>();
+        assert(xs.size() == SIZE && xs[3] == 3.0f);
+        for (float& x : xs) {
+            x += 1.0f;
+        }
+        auto [x, n, s] = v[3];
+        assert(x == 4.0f && n == 6 && s == "3"s);
+        n = 100;
+        assert(v.Column<1>()[3] == 100);
+
+        int sum = 0;
+        for (auto [x, n, s] : v) {
+            sum += n;
+        }
+        assert(sum == 100 + 2 * (0 + 1 + 2 + 4 + 5 + 6 + 7 + 8 + 9));
+        auto it = std::find_if(v.begin(), v.end(), [](const auto& row) {
+            return std::get<2>(row) == "7"s;
+        });
+        assert(it - v.begin() == 7);
+
+        const auto copy = v;
+        v.PopBack();
+        assert(v.Size() == SIZE - 1 && copy.Size() == SIZE && std::get<2>(copy[SIZE - 1]) == "9"s);
+        // Аргумент, ссылающийся на элемент самого вектора
+        v.Reserve(v.Size());
+        v.EmplaceBack(1.0f, 2, std::get<2>(v[0]));
+        v.EmplaceBack(1.0f, 2, std::get<2>(v[1]));
+        assert(std::get<2>(v[SIZE]) == "1"s);
+    }
+    Obj::ResetCounters();
+    {
+        SoAVector<int, Obj> v;
+        v.Reserve(SIZE);
+        v.EmplaceBack(1, 1);
+        // Исключение при создании второго поля уничтожает первое
+        Obj::default_construction_throw_countdown = 1;
+        try {
+            v.EmplaceBack(2, Obj());
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 1 && Obj::GetAliveObjectCount() == 1);
+        v.Reserve(SIZE * 2);
+        assert(v.Capacity() == SIZE * 2 && std::get<1>(v[0]).id == 1 && Obj::GetAliveObjectCount() == 1);
+        std::get<1>(v[0]).throw_on_copy = true;
+        try {
+            auto copy = v;
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
         }
-        Dump();
-    } catch (...) {
+        assert(Obj::GetAliveObjectCount() == 1);
+        v.Clear();
+        assert(v.Size() == 0 && Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        // Перенос столбцов копированием: ошибка во втором столбце откатывает первый
+        struct ThrowingMove {
+            explicit ThrowingMove(int id)
+                : obj(id) {
+            }
+            ThrowingMove(const ThrowingMove&) = default;
+            ThrowingMove(ThrowingMove&& other) noexcept(false) = default;
+            Obj obj;
+        };
+        SoAVector<Obj, ThrowingMove> v;
+        v.Reserve(2);
+        v.EmplaceBack(1, 1);
+        v.EmplaceBack(2, 2);
+        std::get<1>(v[1]).obj.throw_on_copy = true;
+        Obj::ResetCounters();
+        try {
+            v.Reserve(4);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Capacity() == 2 && std::get<0>(v[1]).id == 2 && std::get<1>(v[1]).obj.id == 2);
+        // Копируемый столбец переносится первым, перемещаемый ещё не тронут
+        assert(Obj::num_moved == 0 && Obj::num_copied == 1 && Obj::GetAliveObjectCount() == 0);
+
+        // Столбцы, переносимые перемещением и побайтово, не теряют значений при откате
+        SoAVector<std::string, std::unique_ptr<int>, ThrowingMove> mixed;
+        mixed.Reserve(2);
+        mixed.EmplaceBack(std::string(100, 'a'), std::make_unique<int>(1), 1);
+        mixed.EmplaceBack(std::string(100, 'b'), std::make_unique<int>(2), 2);
+        std::get<2>(mixed[1]).obj.throw_on_copy = true;
+        try {
+            mixed.Reserve(4);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(mixed.Capacity() == 2 && std::get<0>(mixed[1]) == std::string(100, 'b'));
+        assert(*std::get<1>(mixed[0]) == 1 && *std::get<1>(mixed[1]) == 2);
+        std::get<2>(mixed[1]).obj.throw_on_copy = false;
+        mixed.Reserve(4);
+        assert(mixed.Capacity() == 4 && std::get<0>(mixed[0]) == std::string(100, 'a') && *std::get<1>(mixed[1]) == 2);
+    }
+}
+
+void Test20() {
+    const size_t THREADS = 8;
+    const size_t PER_THREAD = 10000;
+    {
+        ConcurrentVector<size_t, 4> v;
+        std::vector<std::vector<size_t>> indices(THREADS);
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < THREADS; ++t) {
+            threads.emplace_back([&v, &indices, t] {
+                for (size_t i = 0; i < PER_THREAD; ++i) {
+                    const size_t value = t * PER_THREAD + i;
+                    const size_t index = v.PushBack(value);
+                    // Опубликованный элемент сразу доступен для чтения
+                    assert(v.IsPublished(index) && v[index] == value);
+                    indices[t].push_back(index);
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        assert(v.Size() == THREADS * PER_THREAD);
+        std::vector<bool> seen(v.Size());
+        for (size_t t = 0; t < THREADS; ++t) {
+            for (size_t i = 0; i < PER_THREAD; ++i) {
+                const size_t index = indices[t][i];
+                assert(!seen[index] && v[index] == t * PER_THREAD + i);
+                seen[index] = true;
+            }
+        }
+        assert(!v.IsPublished(v.Size()));
+    }
+    Obj::ResetCounters();
+    {
+        ConcurrentVector<Obj> v;
+        v.Reserve(1000);
+        const size_t first = v.EmplaceBack(1);
+        const Obj* address = &v[first];
+        for (int i = 0; i < 1000; ++i) {
+            v.EmplaceBack(i);
+        }
+        assert(&v[first] == address && v[first].id == 1);
+        // Индекс элемента, конструктор которого выбросил исключение, не публикуется
+        Obj::default_construction_throw_countdown = 1;
+        try {
+            v.EmplaceBack();
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(v.Size() == 1002 && !v.IsPublished(1001));
+        v.EmplaceBack(2);
+        assert(v.IsPublished(1002) && v[1002].id == 2);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test21() {
+    const size_t SIZE = 1000;
+    Obj::ResetCounters();
+    {
+        SegmentedVector<Obj, 4> v;
+        std::vector<const Obj*> addresses;
+        for (size_t i = 0; i < SIZE; ++i) {
+            addresses.push_back(&v.EmplaceBack(static_cast<int>(i)));
+        }
+        // Элементы не перемещались и не копировались при росте
+        assert(Obj::num_moved == 0 && Obj::num_copied == 0);
+        assert(v.Size() == SIZE && v.Capacity() == 1020);
+        for (size_t i = 0; i < SIZE; ++i) {
+            assert(&v[i] == addresses[i] && v[i].id == static_cast<int>(i));
+        }
+        // Аргумент, ссылающийся на элемент этого же вектора, при добавлении блока
+        while (v.Size() < v.Capacity()) {
+            v.PushBack(v[0]);
+        }
+        v.PushBack(v[1]);
+        assert(v[v.Size() - 1].id == 1 && &v[0] == addresses[0]);
+
+        const SegmentedVector<Obj, 4> copy(v);
+        assert(copy.Size() == v.Size() && copy[SIZE - 1].id == static_cast<int>(SIZE - 1));
+        assert(std::distance(copy.begin(), copy.end()) == static_cast<std::ptrdiff_t>(copy.Size()));
+        while (v.Size() > 10) {
+            v.PopBack();
+        }
+        v.ShrinkToFit();
+        assert(v.Size() == 10 && v.Capacity() == 12 && &v[9] == addresses[9]);
+        v.Clear();
+        assert(v.Size() == 0 && Obj::GetAliveObjectCount() == static_cast<int>(copy.Size()));
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        SegmentedVector<int> v;
+        for (int i = 0; i < 100; ++i) {
+            v.PushBack(100 - i);
+        }
+        std::sort(v.begin(), v.end());
+        assert(std::is_sorted(v.cbegin(), v.cend()) && v[0] == 1 && v[99] == 100);
+        SegmentedVector<int> moved(std::move(v));
+        assert(moved.Size() == 100 && v.Size() == 0);
+    }
+}
+
+void Test22() {
+    const size_t SIZE = 10000;
+    const execution::ParallelPolicy policy{.threads = 4, .min_chunk = 100};
+    {
+        Vector<AtomicObj> v(policy, SIZE);
+        assert(v.Size() == SIZE && v.Capacity() == SIZE && AtomicObj::alive == static_cast<int>(SIZE));
+        assert(std::all_of(v.begin(), v.end(), [](const AtomicObj& c) {
+            return c.id == 7;
+        }));
+        v[SIZE - 1].id = 1;
+        Vector<AtomicObj> copy(policy, v);
+        assert(copy.Size() == SIZE && copy[SIZE - 1].id == 1 && AtomicObj::alive == static_cast<int>(2 * SIZE));
+
+        v.Reserve(policy, 2 * SIZE);
+        assert(v.Capacity() == 2 * SIZE && v[SIZE - 1].id == 1 && AtomicObj::alive == static_cast<int>(2 * SIZE));
+        v.Resize(policy, 3 * SIZE);
+        assert(v.Size() == 3 * SIZE && v[3 * SIZE - 1].id == 7);
+        v.Resize(policy, SIZE / 2);
+        assert(v.Size() == SIZE / 2 && AtomicObj::alive == static_cast<int>(SIZE + SIZE / 2));
+        v.Clear(policy);
+        assert(v.Size() == 0 && AtomicObj::alive == static_cast<int>(SIZE));
+
+        // Исключение в одном из участков: созданные участки уничтожаются
+        AtomicObj::throw_countdown = SIZE / 2;
+        try {
+            Vector<AtomicObj> failed(policy, copy);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(AtomicObj::alive == static_cast<int>(SIZE));
+        AtomicObj::throw_countdown = SIZE;
+        try {
+            copy.Resize(policy, 2 * SIZE);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(copy.Size() == SIZE && AtomicObj::alive == static_cast<int>(SIZE));
+        AtomicObj::throw_countdown = 0;
+    }
+    assert(AtomicObj::alive == 0);
+    {
+        Vector<std::string> v(execution::seq, 3);
+        v.Resize(execution::par, 5);
+        assert(v.Size() == 5 && v[4].empty());
+    }
+}
+
+void Test23() {
+    const size_t THRESHOLD = 4096;
+    {
+        // Рост через reallocate: malloc, затем переход на mmap и mremap
+        Vector<int, HugePageAllocator<int, THRESHOLD>> v;
+        for (int i = 0; i < 1'000'000; ++i) {
+            v.PushBack(i);
+        }
+        assert(v[999'999] == 999'999 && v[THRESHOLD] == static_cast<int>(THRESHOLD));
+        // После роста через mremap буфер по-прежнему выровнен для больших страниц
+        const auto address = reinterpret_cast<std::uintptr_t>(v.Data());
+        assert(address % HugePageAllocator<int>::HUGE_PAGE_SIZE == 0);
+        v.Resize(10);
+        v.ShrinkToFit();
+        assert(v.Capacity() == 10 && v[9] == 9);
+    }
+    {
+        const HugePageAllocator<std::string, THRESHOLD> alloc(HugePageOptions{.numa_node = 0});
+        Vector<std::string, HugePageAllocator<std::string, THRESHOLD>> v(alloc);
+        for (size_t i = 0; i < 1000; ++i) {
+            v.EmplaceBack(std::to_string(i));
+        }
+        assert(v[999] == "999" && v.GetAllocator().GetOptions().numa_node == 0);
+        const auto address = reinterpret_cast<std::uintptr_t>(v.Data());
+        assert(address % HugePageAllocator<std::string>::HUGE_PAGE_SIZE == 0);
+        const auto copy = v;
+        assert(copy[500] == "500" && copy.GetAllocator().GetOptions().numa_node == 0);
+    }
+    {
+        // Узел вне маски не привязывается, и отказ виден по счётчику
+        const size_t failures = GetHugePageBindFailures().load();
+        using Allocator = HugePageAllocator<int, THRESHOLD>;
+        Vector<int, Allocator> v(Allocator(HugePageOptions{.numa_node = 64}));
+        v.Resize(THRESHOLD);
+        assert(GetHugePageBindFailures().load() > failures && v[THRESHOLD - 1] == 0);
+    }
+    {
+        HugePageVector<double> v(HugePageAllocator<double>(HugePageOptions{.explicit_huge_pages = true}));
+        v.Resize(1 << 19);
+        v[(1 << 19) - 1] = 1.0;
+        v.Reserve(1 << 20);
+        assert(v[(1 << 19) - 1] == 1.0 && v[0] == 0.0);
+    }
+    {
+        // Буфер переходит только вместе с аллокатором, который его отобразил
+        using Allocator = HugePageAllocator<int, THRESHOLD>;
+        const Allocator bound(HugePageOptions{.numa_node = 0});
+        const Allocator explicit_pages(HugePageOptions{.explicit_huge_pages = true});
+        assert(bound != explicit_pages && bound == Allocator(HugePageOptions{.numa_node = 0}));
+        Vector<int, Allocator> source(THRESHOLD, bound);
+        source[THRESHOLD - 1] = 1;
+        const int* data = source.Data();
+        Vector<int, Allocator> target(THRESHOLD * 2, explicit_pages);
+        target = std::move(source);
+        assert(target.Data() == data && target[THRESHOLD - 1] == 1);
+        assert(target.GetAllocator() == bound);
+        target.Reserve(THRESHOLD * 4);
+        assert(target.Size() == THRESHOLD && target[THRESHOLD - 1] == 1);
+
+        Vector<int, Allocator> other(THRESHOLD, explicit_pages);
+        target.Swap(other);
+        assert(target.GetAllocator() == explicit_pages && other.GetAllocator() == bound);
+        assert(other[THRESHOLD - 1] == 1);
+    }
+}
+
+void Test24() {
+#if defined(__unix__)
+    struct Record {
+        int id;
+        double value;
+    };
+    const std::string path = "mapped_vector_test.bin";
+    const size_t SIZE = 10000;
+    {
+        auto v = MappedVector<Record>::Create(path);
+        assert(v.Size() == 0 && v.Capacity() == 0 && v.begin() == v.end());
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack({static_cast<int>(i), i * 0.5});
+        }
+        assert(v.Size() == SIZE && v.Capacity() >= SIZE && v[SIZE - 1].id == static_cast<int>(SIZE - 1));
+        // Аргумент, ссылающийся на элемент этого же вектора, при росте
+        v.Reserve(v.Size());
+        v.EmplaceBack(v[0]);
+        v.PopBack();
+        v.Sync();
+    }
+    {
+        auto v = MappedVector<Record>::Open(path, MappedVector<Record>::Mode::READ_ONLY);
+        const auto& view = v;
+        assert(v.IsReadOnly() && view.Size() == SIZE && view[123].id == 123 && view[123].value == 61.5);
+        int sum = 0;
+        for (const Record& record : view) {
+            sum += record.id % 2;
+        }
+        assert(sum == static_cast<int>(SIZE / 2));
+        try {
+            v.PushBack({0, 0.0});
+            assert(false && "Exception is expected");
+        } catch (const std::logic_error&) {
+        }
+        // Неконстантный доступ к отображению только для чтения не завершает процесс
+        try {
+            v[0].id = 1;
+            assert(false && "Exception is expected");
+        } catch (const std::logic_error&) {
+        }
+        try {
+            [[maybe_unused]] auto it = v.begin();
+            assert(false && "Exception is expected");
+        } catch (const std::logic_error&) {
+        }
+    }
+    {
+        auto v = MappedVector<Record>::Open(path);
+        v.Resize(SIZE / 2);
+        v[0].id = 42;
+        auto moved = std::move(v);
+        moved.Resize(SIZE);
+        assert(moved[0].id == 42 && moved[SIZE - 1].id == 0);
+        // Вместимость, длина файла для которой не умещается в size_t
+        try {
+            moved.Reserve(SIZE_MAX / sizeof(Record));
+            assert(false && "Exception is expected");
+        } catch (const std::length_error&) {
+        }
+        assert(moved.Capacity() >= SIZE && moved[0].id == 42);
+    }
+    try {
+        MappedVector<int64_t>::Open(path);
+        assert(false && "Exception is expected");
+    } catch (const std::runtime_error&) {
+    }
+    std::remove(path.c_str());
+    try {
+        MappedVector<Record>::Open(path);
+        assert(false && "Exception is expected");
+    } catch (const std::system_error& e) {
+        assert(e.code() == std::errc::no_such_file_or_directory);
+    }
+#endif
+}
+
+void Test25() {
+    using namespace std::literals;
+    const size_t SIZE = 100'000;
+    {
+        Vector<int> v;
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.PushBack(static_cast<int>(i));
+        }
+        {
+            std::FILE* file = std::tmpfile();
+            assert(file != nullptr);
+            WriteTo(file, v);
+            WriteTo(file, Vector<int>{});
+            std::rewind(file);
+            Vector<int> read{1, 2, 3};
+            ReadFrom(file, read);
+            assert(read.Size() == SIZE && read[SIZE - 1] == static_cast<int>(SIZE - 1));
+            ReadFrom(file, read);
+            assert(read.Size() == 0);
+            try {
+                ReadFrom(file, read);
+                assert(false && "Exception is expected");
+            } catch (const std::runtime_error&) {
+            }
+            std::fclose(file);
+        }
+#if defined(__unix__)
+        const std::string path = "vector_io_test.bin";
+        const int out = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        WriteTo(out, v);
+        WriteTo(out, Vector<int>{});
+        ::close(out);
+
+        const int in = ::open(path.c_str(), O_RDONLY);
+        Vector<int> read{1, 2, 3};
+        ReadFrom(in, read);
+        assert(read.Size() == SIZE && read[SIZE - 1] == static_cast<int>(SIZE - 1));
+        ReadFrom(in, read);
+        assert(read.Size() == 0);
+        try {
+            ReadFrom(in, read);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        ::close(in);
+        std::remove(path.c_str());
+#endif
+
+        std::stringstream stream;
+        WriteTo(stream, v);
+        Vector<double> wrong_type;
+        try {
+            ReadFrom(stream, wrong_type);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        stream.seekg(0);
+        Vector<int> from_stream;
+        ReadFrom(stream, from_stream);
+        assert(from_stream.Size() == SIZE && from_stream[12345] == 12345);
+
+        // Непрошедший проверку заголовок тоже оставляет вектор пустым
+        std::stringstream wrong_stream;
+        WriteTo(wrong_stream, v);
+        wrong_type = {1.0, 2.0};
+        try {
+            ReadFrom(wrong_stream, wrong_type);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(wrong_type.Size() == 0);
+    }
+    {
+        // Данные из нескольких участков: вместимость растёт геометрически, а не на участок
+        const size_t CHUNKS = 8;
+        const size_t size = VECTOR_IO_CHUNK_ELEMENTS<int> * CHUNKS;
+        Vector<int> v(size);
+        std::iota(v.begin(), v.end(), 0);
+        const size_t reallocations = std::bit_width(CHUNKS);
+
+#if defined(__unix__)
+        int fds[2];
+        assert(::pipe(fds) == 0);
+        std::thread writer([&] {
+            WriteTo(fds[1], v);
+            ::close(fds[1]);
+        });
+        VectorStats<int>::Reset();
+        Vector<int> from_pipe;
+        ReadFrom(fds[0], from_pipe);
+        writer.join();
+        ::close(fds[0]);
+        assert(from_pipe.Size() == size && from_pipe[size - 1] == static_cast<int>(size - 1));
+        assert(VectorStats<int>::Snapshot().reallocations == reallocations);
+        assert(VectorStats<int>::Snapshot().relocated_by_memcpy < size);
+#endif
+
+        std::stringstream stream;
+        WriteTo(stream, v);
+        VectorStats<int>::Reset();
+        Vector<int> from_stream;
+        ReadFrom(stream, from_stream);
+        assert(from_stream.Size() == size && from_stream[size / 2] == static_cast<int>(size / 2));
+        assert(VectorStats<int>::Snapshot().reallocations == reallocations);
+        assert(VectorStats<int>::Snapshot().relocated_by_memcpy < size);
+    }
+    {
+        // Повреждённое число элементов не приводит к попытке выделить терабайты памяти
+        const VectorIoHeader header = VectorIoHeader::For(sizeof(int), uint64_t{1} << 40);
+        const std::string corrupt(reinterpret_cast<const char*>(&header), sizeof(header));
+        std::stringstream stream(corrupt + "data");
+        Vector<int> read;
+        try {
+            ReadFrom(stream, read);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(read.Size() == 0);
+
+        std::FILE* file = std::tmpfile();
+        assert(file != nullptr);
+        assert(std::fwrite(corrupt.data(), 1, corrupt.size(), file) == corrupt.size());
+        std::rewind(file);
+        try {
+            ReadFrom(file, read);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        std::fclose(file);
+        assert(read.Size() == 0);
+
+#if defined(__unix__)
+        const std::string path = "vector_io_corrupt.bin";
+        const int out = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        assert(::write(out, corrupt.data(), corrupt.size()) == static_cast<ssize_t>(corrupt.size()));
+        ::close(out);
+        const int in = ::open(path.c_str(), O_RDONLY);
+        try {
+            ReadFrom(in, read);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        ::close(in);
+        std::remove(path.c_str());
+
+        // Из канала объём заранее неизвестен, данные читаются участками
+        int fds[2];
+        assert(::pipe(fds) == 0);
+        assert(::write(fds[1], corrupt.data(), corrupt.size()) == static_cast<ssize_t>(corrupt.size()));
+        ::close(fds[1]);
+        try {
+            ReadFrom(fds[0], read);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        ::close(fds[0]);
+        assert(read.Size() == 0);
+#endif
+
+        std::string bad_string = corrupt;
+        VectorIoHeader strings_header = VectorIoHeader::For(sizeof(std::string), 1);
+        std::memcpy(bad_string.data(), &strings_header, sizeof(strings_header));
+        const uint64_t huge = uint64_t{1} << 40;
+        bad_string.append(reinterpret_cast<const char*>(&huge), sizeof(huge));
+        std::stringstream strings_stream(bad_string);
+        Vector<std::string> strings;
+        try {
+            ReadFrom(strings_stream, strings);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+    }
+    {
+        const Vector<std::string> strings{"a"s, ""s, std::string(100, 'x')};
+        std::stringstream stream;
+        WriteTo(stream, strings);
+        Vector<std::string> read;
+        ReadFrom(stream, read);
+        assert(read.Size() == 3 && read[0] == "a"s && read[1].empty() && read[2] == strings[2]);
+
+        // Обрезанные данные: вектор остаётся пустым
+        std::stringstream truncated(stream.str().substr(0, stream.str().size() - 10));
+        try {
+            ReadFrom(truncated, read);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(read.Size() == 0);
+    }
+    Obj::ResetCounters();
+    {
+        Vector<Obj> v;
+        v.EmplaceBack(1, "one"s);
+        v.EmplaceBack(2, "two"s);
+        std::stringstream stream;
+        WriteTo(stream, v);
+        Vector<Obj> read;
+        ReadFrom(stream, read);
+        // Конструктор перемещения Obj не переносит name, поэтому проверяются id
+        assert(read.Size() == 2 && read[0].id == 1 && read[1].id == 2);
+        assert(Obj::num_constructed_with_id_and_name == 4);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test26() {
+    const size_t SIZE = 10;
+    Obj::ResetCounters();
+    {
+        Vector<Obj> v;
+        v.Reserve(SIZE + 1);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        const Obj value(100);
+        Obj::ResetCounters();
+        // Без временного объекта: последний элемент перемещается за конец, хвост сдвигается,
+        // значение присваивается в освободившуюся ячейку
+        v.Insert(v.begin() + 2, value);
+        assert(Obj::num_moved == 1 && Obj::num_move_assigned == static_cast<int>(SIZE - 3));
+        assert(Obj::num_assigned == 1 && Obj::num_copied == 0 && Obj::num_destroyed == 0);
+        assert(v.Size() == SIZE + 1 && v[2].id == 100 && v[3].id == 2 && v[SIZE].id == static_cast<int>(SIZE - 1));
+    }
+    {
+        // Аргумент — элемент сдвигаемого хвоста
+        Vector<Obj> v;
+        v.Reserve(SIZE * 2);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        v.Insert(v.begin() + 1, v[5]);
+        assert(v[1].id == 5 && v[6].id == 5 && v.Size() == SIZE + 1);
+        v.Insert(v.begin(), v[v.Size() - 1]);
+        assert(v[0].id == static_cast<int>(SIZE - 1) && v[v.Size() - 1].id == static_cast<int>(SIZE - 1));
+        v.Insert(v.begin() + 3, std::move(v[0]));
+        assert(v[3].id == static_cast<int>(SIZE - 1));
+        v.Emplace(v.begin() + 4, v[5].id);
+        assert(v[4].id == v[6].id);
+    }
+    RelocatableObj::ResetCounters();
+    {
+        Vector<RelocatableObj> v(SIZE);
+        v.Reserve(SIZE * 2);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v[i].id = static_cast<int>(i);
+        }
+        const RelocatableObj value;
+        RelocatableObj::ResetCounters();
+        // Хвост сдвигается memmove, элемент создаётся сразу в своей ячейке
+        v.Insert(v.begin() + 2, value);
+        assert(RelocatableObj::num_copied == 1 && RelocatableObj::num_moved == 0);
+        assert(RelocatableObj::num_destroyed == 0);
+        v.Insert(v.begin(), v[5]);
+        assert(v[0].id == 4 && v[6].id == 4 && RelocatableObj::num_copied == 2);
+        v.Emplace(v.begin() + 1);
+        assert(v[1].id == 0 && v[2].id == 0 && v.Size() == SIZE + 3);
+    }
+    {
+        // unique_ptr тривиально перемещаем: хвост переносится memmove
+        Vector<std::unique_ptr<int>> v;
+        v.Reserve(4);
+        v.PushBack(std::make_unique<int>(1));
+        v.PushBack(std::make_unique<int>(2));
+        v.Emplace(v.begin(), std::make_unique<int>(0));
+        assert(*v[0] == 0 && *v[1] == 1 && *v[2] == 2);
+    }
+}
+
+void Test27() {
+    {
+        FlatSet<int> set{5, 1, 3, 1, 9};
+        assert(set.Size() == 4 && set[0] == 1 && set[3] == 9);
+        assert(set.Contains(3) && !set.Contains(4));
+        assert(*set.LowerBound(4) == 5 && set.LowerBound(10) == set.end());
+        auto [it, inserted] = set.Insert(4);
+        assert(inserted && *it == 4 && set.Size() == 5);
+        assert(!set.Insert(4).second && set.Size() == 5);
+        assert(set.Erase(1) == 1 && set.Erase(1) == 0 && *set.begin() == 3);
+        set.Erase(set.Find(9));
+        const std::vector<int> more = {7, 3, 6, 7, 2};
+        set.InsertUnsorted(more);
+        const std::vector<int> expected = {2, 3, 4, 5, 6, 7};
+        assert(std::equal(set.begin(), set.end(), expected.begin(), expected.end()));
+        // Ключи больше имеющихся дописываются без слияния
+        set.InsertUnsorted(std::vector<int>{9, 8, 9});
+        assert(set.Size() == 8 && set[6] == 8 && set[7] == 9);
+    }
+    {
+        // Исключение компаратора при сортировке или слиянии оставляет множество прежним
+        struct ThrowingLess {
+            int* budget;
+
+            bool operator()(int lhs, int rhs) const {
+                if ((*budget)-- == 0) {
+                    throw std::runtime_error("compare");
+                }
+                return lhs < rhs;
+            }
+        };
+        const std::vector<int> initial = {10, 20, 30, 40};
+        const std::vector<int> more = {35, 5, 25, 15, 20};
+        for (int calls = 0;; ++calls) {
+            int budget = -1;
+            FlatSet<int, ThrowingLess> set(ThrowingLess{&budget});
+            set.InsertUnsorted(initial);
+            budget = calls;
+            try {
+                set.InsertUnsorted(more);
+            } catch (const std::runtime_error&) {
+                assert(std::equal(set.begin(), set.end(), initial.begin(), initial.end()));
+                continue;
+            }
+            assert(set.Size() == 8 && std::is_sorted(set.begin(), set.end()));
+            break;
+        }
+    }
+    {
+        // Индекс Эйтцингера даёт те же ответы, что и двоичный поиск
+        std::vector<int> keys;
+        for (int i = 0; i < 1000; ++i) {
+            keys.push_back(i * 2);
+        }
+        FlatSet<int> set;
+        set.InsertUnsorted(keys);
+        std::vector<const int*> expected;
+        for (int key = -1; key <= 2000; ++key) {
+            expected.push_back(set.LowerBound(key));
+        }
+        set.BuildSearchIndex();
+        for (int key = -1; key <= 2000; ++key) {
+            assert(set.LowerBound(key) == expected[key + 1]);
+        }
+        assert(set.Contains(998) && !set.Contains(999));
+        // Изменение сбрасывает индекс
+        set.Insert(999);
+        assert(set.Contains(999) && set.Size() == 1001);
+        for (size_t n = 1; n < 40; ++n) {
+            FlatSet<int> small;
+            small.InsertUnsorted(std::vector<int>(keys.begin(), keys.begin() + n));
+            small.BuildSearchIndex();
+            for (int key = -1; key <= static_cast<int>(2 * n); ++key) {
+                const auto it = small.LowerBound(key);
+                assert(it == std::lower_bound(small.begin(), small.end(), key));
+            }
+        }
+    }
+    {
+        FlatMap<std::string, int> map{{"b", 2}, {"a", 1}, {"c", 3}, {"a", 10}};
+        assert(map.Size() == 3 && map.At("a") == 1 && map.Keys()[2] == "c");
+        map["d"] = 4;
+        ++map["a"];
+        assert(map.At("a") == 2 && map.At("d") == 4 && map.Size() == 4);
+        assert(!map.Insert("b", 20).second && map.At("b") == 2);
+        assert(!map.InsertOrAssign("b", 20).second && map.At("b") == 20);
+        const auto it = map.Find("c");
+        assert(it != map.end() && it->first == "c" && it->second == 3);
+        map.Erase(it);
+        assert(map.Erase("c") == 0 && map.Erase("d") == 1 && map.Size() == 2);
+        try {
+            map.At("z");
+            assert(false);
+        } catch (const std::out_of_range&) {
+        }
+        std::vector<std::pair<std::string, int>> more = {{"e", 5}, {"a", 100}, {"f", 6}, {"e", 50}};
+        map.InsertUnsorted(more);
+        map.BuildSearchIndex();
+        assert(map.Size() == 4 && map.At("a") == 2 && map.At("e") == 5 && map.At("f") == 6);
+        int sum = 0;
+        for (const auto& [key, value] : std::as_const(map)) {
+            sum += value;
+        }
+        assert(sum == 2 + 20 + 5 + 6);
+        for (int& value : map.Values()) {
+            value = 0;
+        }
+        assert(map.At("e") == 0);
+    }
+    {
+        // Ключи больше имеющихся дописываются без перестановки имеющихся пар
+        FlatMap<int, std::string> map{{1, "a"}, {3, "c"}};
+        map.Reserve(16);
+        const std::string* first_value = &map.Values()[0];
+        map.InsertUnsorted(std::vector<std::pair<int, std::string>>{});
+        map.InsertUnsorted(std::vector<std::pair<int, std::string>>{{4, "d"}, {5, "e"}});
+        map.InsertUnsorted(std::vector<std::pair<int, std::string>>{{9, "i"}, {7, "g"}, {9, "x"}, {7, "y"}});
+        assert(&map.Values()[0] == first_value && map.Size() == 6);
+        const std::vector<int> keys = {1, 3, 4, 5, 7, 9};
+        assert(std::equal(map.Keys().begin(), map.Keys().end(), keys.begin(), keys.end()));
+        assert(map.At(7) == "g" && map.At(9) == "i" && map.At(4) == "d");
+        // Новый ключ внутри диапазона имеющихся требует слияния
+        map.InsertUnsorted(std::vector<std::pair<int, std::string>>{{2, "b"}, {9, "z"}});
+        assert(map.Size() == 7 && map.Keys()[1] == 2 && map.At(2) == "b" && map.At(9) == "i");
+    }
+    {
+        // Исключение при копировании значения не оставляет столбцы разной длины
+        FlatMap<int, Obj> map;
+        map.TryEmplace(1, 1);
+        std::vector<std::pair<int, Obj>> more;
+        more.emplace_back(3, Obj(3));
+        more.emplace_back(2, Obj(2));
+        more.back().second.throw_on_copy = true;
+        try {
+            map.InsertUnsorted(more);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(map.Size() == 1 && map.Keys().size() == 1 && map.Values().size() == 1 && map.At(1).id == 1);
+        assert(!map.Contains(3));
+        // То же при дописывании ключей, больших имеющихся
+        more.clear();
+        more.emplace_back(5, Obj(5));
+        more.emplace_back(4, Obj(4));
+        more.back().second.throw_on_copy = true;
+        try {
+            map.InsertUnsorted(more);
+            assert(false && "Exception is expected");
+        } catch (const std::runtime_error&) {
+        }
+        assert(map.Size() == 1 && map.Values().size() == 1 && map.At(1).id == 1);
+        static_assert(std::random_access_iterator<FlatMap<int, Obj>::iterator>);
+        static_assert(std::is_same_v<std::iterator_traits<FlatMap<int, Obj>::iterator>::iterator_category,
+                                     std::input_iterator_tag>);
+    }
+}
+
+void Test28() {
+    const size_t SIZE = 100;
+    Obj::ResetCounters();
+    {
+        CowVector<Obj> v;
+        assert(v.Size() == 0 && v.UseCount() == 0 && v.begin() == v.end());
+        v.Reserve(SIZE);
+        for (size_t i = 0; i < SIZE; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        const int copied = Obj::num_copied;
+        // Копии разделяют буфер, элементы не копируются
+        CowVector<Obj> snapshot = v;
+        CowVector<Obj> other;
+        other = snapshot;
+        assert(Obj::num_copied == copied && v.UseCount() == 3 && snapshot.begin() == v.begin());
+
+        // Первое изменение копирует элементы один раз
+        v.Mutate()[0].id = -1;
+        assert(Obj::num_copied == copied + static_cast<int>(SIZE) && v.UseCount() == 1 && snapshot.UseCount() == 2);
+        assert(v[0].id == -1 && snapshot[0].id == 0 && other[0].id == 0);
+        v.PushBack(Obj(1000));
+        assert(Obj::num_copied == copied + static_cast<int>(SIZE) && v.Size() == SIZE + 1 && snapshot.Size() == SIZE);
+
+        // Разделённый буфер при очистке отпускается без копирования
+        other.Clear();
+        assert(other.Size() == 0 && snapshot.UseCount() == 1 && Obj::num_copied == copied + static_cast<int>(SIZE));
+        CowVector<Obj> moved = std::move(snapshot);
+        assert(moved.UseCount() == 1 && snapshot.UseCount() == 0 && moved.Size() == SIZE);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        // Читатели в разных потоках держат свои копии, пока владелец публикует новые версии
+        CowVector<int> config{1, 2, 3};
+        std::atomic<bool> stop = false;
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 4; ++t) {
+            readers.emplace_back([&stop, snapshot = config] {
+                while (!stop.load()) {
+                    CowVector<int> local = snapshot;
+                    assert(local.Size() == 3 && local[0] == 1);
+                }
+            });
+        }
+        for (int i = 0; i < 1000; ++i) {
+            CowVector<int> next = config;
+            next.PushBack(i);
+            next.PopBack();
+            config = next;
+        }
+        stop = true;
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        assert(config.UseCount() == 1 && config.Get().Size() == 3);
+    }
+}
+
+// Таблица квадратов, построенная при компиляции
+constexpr StaticVector<int, 16> MakeSquares() {
+    StaticVector<int, 16> squares;
+    for (int i = 0; squares.TryEmplaceBack(i * i) != nullptr; ++i) {
+    }
+    squares.Erase(squares.begin());
+    squares.Insert(squares.begin(), -1);
+    return squares;
+}
+
+void Test29() {
+    {
+        constexpr StaticVector<int, 16> SQUARES = MakeSquares();
+        static_assert(SQUARES.Size() == 16 && SQUARES[0] == -1 && SQUARES[15] == 225);
+        static_assert(std::is_trivially_copyable_v<StaticVector<int, 16>>);
+        StaticVector<int, 16> copy = SQUARES;
+        copy.Resize(4);
+        assert(copy.Size() == 4 && copy[3] == 9);
+        copy.Clear();
+        assert(copy.Size() == 0 && copy.Capacity() == 16);
+    }
+    const size_t SIZE = 8;
+    Obj::ResetCounters();
+    {
+        StaticVector<Obj, SIZE> v;
+        for (size_t i = 0; i + 1 < SIZE; ++i) {
+            v.EmplaceBack(static_cast<int>(i));
+        }
+        const int copied = Obj::num_copied;
+        v.Insert(v.begin() + 1, v[4]);
+        assert(v.Size() == SIZE && v[1].id == 4 && v[2].id == 1 && v[SIZE - 1].id == static_cast<int>(SIZE - 2));
+        // Значение присваивается в ячейку без временной копии
+        assert(Obj::num_copied == copied && Obj::num_assigned == 1);
+        assert(v.TryEmplaceBack(100) == nullptr);
+        try {
+            v.EmplaceBack(100);
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+        try {
+            v.Resize(SIZE + 1);
+            assert(false);
+        } catch (const std::length_error&) {
+        }
+        assert(v.Size() == SIZE);
+        v.Erase(v.begin(), v.begin() + 2);
+        assert(v.Size() == SIZE - 2 && v[0].id == 1);
+
+        StaticVector<Obj, SIZE> copy = v;
+        StaticVector<Obj, SIZE> moved = std::move(copy);
+        copy = moved;
+        copy.Resize(2);
+        moved = copy;
+        assert(moved.Size() == 2 && moved[1].id == 2 && v.Size() == SIZE - 2);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        StaticVector<std::string, 4> names{"a", "b"};
+        names.Emplace(names.begin(), 3, 'c');
+        assert(names.Size() == 3 && names[0] == "ccc" && names[2] == "b");
+        names.PopBack();
+        assert(names.Size() == 2);
+        // Пустой диапазон не затрагивает элементы
+        names.Erase(names.begin() + 1, names.begin() + 1);
+        assert(names.Size() == 2 && names[0] == "ccc" && names[1] == "a");
+    }
+}
+
+void Test30() {
+    CapacityHint hint;
+    assert(hint.Suggest() == 0);
+    // Первое заполнение растёт как обычно, следующие выделяют память один раз
+    const size_t sizes[] = {100, 90, 120, 80};
+    size_t regrowths = 0;
+    for (const size_t size : sizes) {
+        Vector<int> v;
+        auto tracker = hint.Track(v);
+        size_t capacity = v.Capacity();
+        for (size_t i = 0; i < size; ++i) {
+            v.PushBack(static_cast<int>(i));
+            if (v.Capacity() != capacity) {
+                capacity = v.Capacity();
+                ++regrowths;
+            }
+        }
+    }
+    assert(hint.Suggest() == 120);
+    // Восемь регулярных ростов до 100 и один до 120
+    assert(regrowths == 9);
+
+    // Выброс забывается через HISTORY заполнений
+    for (size_t i = 0; i < CapacityHint::HISTORY; ++i) {
+        hint.Record(10);
+    }
+    assert(hint.Suggest() == 10);
+    Vector<int> v;
+    v.Reserve(hint);
+    assert(v.Capacity() == 10);
+
+    // Вместимость по подсказке округляется политикой роста
+    AlignedVector<float> aligned;
+    aligned.Reserve(hint);
+    assert(aligned.Capacity() == 16);
+}
+
+#if defined(__unix__)
+// Выполняет action в дочернем процессе и возвращает true, если сработала проверка вектора.
+// Проверки стоят в noexcept-функциях, поэтому обработчик не может выбросить исключение,
+// и нарушение наблюдается только по завершению процесса
+template <typename Action>
+bool FailsVectorCheck(Action action) {
+    const pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        SetVectorCheckHandler([](const char* /*message*/) {
+            _exit(42);
+        });
+        action();
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 42;
+}
+#endif
+
+void Test31() {
+    // Уровень проверок входит в искажённое имя Vector
+    static_assert(std::is_same_v<Vector<int>, VECTOR_CHECK_NAMESPACE(VECTOR_CHECK_LEVEL)::Vector<int>>);
+    // Срабатывание проверок проверяется в дочерних процессах, на других платформах пропускается
+#if defined(__unix__)
+    if constexpr (VECTOR_BOUNDS_CHECKS) {
+        assert(!FailsVectorCheck([] {
+            Vector<int> v(3);
+            v[2] = 1;
+            v.Erase(v.begin(), v.end());
+        }));
+        assert(FailsVectorCheck([] {
+            Vector<int> v(3);
+            v[3] = 1;
+        }));
+        assert(FailsVectorCheck([] {
+            Vector<std::string> v;
+            v.PopBack();
+        }));
+        assert(FailsVectorCheck([] {
+            Vector<int> v(3);
+            v.Erase(v.end());
+        }));
+        assert(FailsVectorCheck([] {
+            Vector<int> v(3);
+            Vector<int> other(3);
+            v.Insert(other.begin(), 1);
+        }));
+    }
+    if constexpr (VECTOR_CHECKED_ITERATORS) {
+        // Итератор, полученный до реаллокации, обнаруживается при разыменовании
+        assert(FailsVectorCheck([] {
+            Vector<int> v(1);
+            const auto it = v.begin();
+            v.Reserve(100);
+            [[maybe_unused]] const int value = *it;
+        }));
+        assert(FailsVectorCheck([] {
+            SmallVector<Obj, 2> v(2);
+            const auto it = v.begin() + 1;
+            v.EmplaceBack(3);
+            v.Insert(it, Obj(4));
+        }));
+        // Элементы встроенного буфера переносятся поштучно, итераторы на них недействительны
+        assert(FailsVectorCheck([] {
+            SmallVector<int, 4> v(3);
+            const auto it = v.cbegin();
+            SmallVector<int, 4> other = std::move(v);
+            [[maybe_unused]] const int value = *it;
+        }));
+        // Итератор на освобождённый при присваивании буфер по-прежнему обнаруживается
+        assert(FailsVectorCheck([] {
+            Vector<int> v{1};
+            Vector<int> tmp{5, 6};
+            const auto it = v.cbegin();
+            v = std::move(tmp);
+            [[maybe_unused]] const int value = *it;
+        }));
+        // Без реаллокации итераторы остаются действительными
+        assert(!FailsVectorCheck([] {
+            Vector<int> v(1);
+            v.Reserve(10);
+            auto it = v.begin();
+            v.PushBack(2);
+            *it = 5;
+            v.Insert(v.begin() + 1, *it);
+            assert(v[1] == 5);
+        }));
+    }
+#endif
+    {
+        // Итераторы следуют за буфером в куче при перемещении и обмене. Проверка выполняется
+        // в этом же процессе: ложное срабатывание завершит тесты
+        Vector<int> v(3);
+        const auto it = v.cbegin();
+        Vector<int> other = std::move(v);
+        assert(*it == 0 && it + 3 == other.cend());
+    }
+    {
+        Vector<int> v{1, 2, 3};
+        Vector<int> other{4};
+        const auto it = v.begin() + 1;
+        const auto other_it = other.begin();
+        v.Swap(other);
+        std::swap(v, other);
+        v.Swap(other);
+        assert(*it == 2 && *other_it == 4 && other.begin() + 1 == it);
+    }
+    {
+        Vector<int> v{1};
+        auto it = v.begin();
+        {
+            Vector<int> tmp{5, 6};
+            it = tmp.begin();
+            v = std::move(tmp);
+        }
+        *it = 7;
+        assert(v[0] == 7);
+    }
+}
+
+void Test32() {
+    using Pool = VectorPool<int, 1024 * sizeof(int)>;
+    Pool::Trim();
+    const int* buffer = nullptr;
+    size_t capacity = 0;
+    {
+        auto handle = Pool::Acquire(100);
+        assert(handle->Capacity() >= 100 && handle->Size() == 0);
+        handle->PushBack(1);
+        buffer = handle->Data();
+        capacity = handle->Capacity();
+    }
+    assert(Pool::PooledCount() == 1 && Pool::RetainedBytes() == capacity * sizeof(int));
+    {
+        // Память предыдущего вектора используется повторно, содержимое очищено
+        auto handle = Pool::Acquire(50);
+        assert(handle->Data() == buffer && handle->Size() == 0 && Pool::PooledCount() == 0);
+        // Недостаточной вместимости: вектор из пула расширяется
+        handle.Reset();
+        auto bigger = Pool::Acquire(200);
+        assert(bigger->Capacity() >= 200 && Pool::PooledCount() == 0 && Pool::RetainedBytes() == 0);
+    }
+    assert(Pool::PooledCount() == 1);
+    {
+        // Вектор сверх лимита не удерживается
+        Pool::Values large;
+        large.Reserve(2000);
+        Pool::Release(std::move(large));
+        assert(Pool::PooledCount() == 1 && Pool::RetainedBytes() == 200 * sizeof(int));
+        // Отклонённый пулом вектор освобождается уже в Reset, а не в деструкторе Handle
+        Pool::Values rejected;
+        rejected.Reserve(2000);
+        Pool::Handle rejected_handle(std::move(rejected));
+        rejected_handle.Reset();
+        assert(rejected_handle->Capacity() == 0 && Pool::PooledCount() == 1);
+        auto first = Pool::Acquire(10);
+        auto second = Pool::Acquire(10);
+        Pool::Values detached = second.Detach();
+        assert(detached.Capacity() >= 10);
+    }
+    assert(Pool::PooledCount() == 1);
+    // У каждого потока свой список
+    std::thread([] {
+        assert(Pool::PooledCount() == 0);
+        auto handle = Pool::Acquire(10);
+    }).join();
+    assert(Pool::PooledCount() == 1);
+    // Handle, созданный раньше списка потока, уничтожается после него и освобождает вектор сам
+    std::thread([] {
+        thread_local Pool::Handle late_handle;
+        late_handle = Pool::Acquire(10);
+        assert(late_handle->Capacity() >= 10);
+    }).join();
+    Pool::Trim();
+    assert(Pool::PooledCount() == 0 && Pool::RetainedBytes() == 0);
+
+    Obj::ResetCounters();
+    {
+        auto handle = VectorPool<Obj>::Acquire();
+        handle->EmplaceBack(1);
+        handle->EmplaceBack(2);
+    }
+    assert(Obj::GetAliveObjectCount() == 0 && VectorPool<Obj>::PooledCount() == 1);
+    VectorPool<Obj>::Trim();
+}
+
+void Test33() {
+    TaskScheduler scheduler(4);
+    {
+        // Вложенные группы: задачи ждут своих подзадач, не блокируя рабочие потоки
+        std::atomic<int> leaves = 0;
+        std::function<void(int)> spawn = [&](int depth) {
+            if (depth == 0) {
+                ++leaves;
+                return;
+            }
+            TaskGroup group(scheduler);
+            group.Run([&, depth] {
+                spawn(depth - 1);
+            });
+            group.Run([&, depth] {
+                spawn(depth - 1);
+            });
+            group.Wait();
+        };
+        spawn(10);
+        assert(leaves == 1 << 10);
+        TaskGroup group(scheduler);
+        group.Run([] {
+            throw std::runtime_error("task");
+        });
+        try {
+            group.Wait();
+            assert(false);
+        } catch (const std::runtime_error&) {
+        }
+    }
+#if defined(__unix__)
+    {
+        // Когда задач нет, ожидающий поток спит, а не занимает ядро. Процессорное время
+        // потока измеряется часами POSIX
+        const auto thread_cpu_ns = [] {
+            timespec ts{};
+            clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+            return ts.tv_sec * 1'000'000'000LL + ts.tv_nsec;
+        };
+        TaskGroup group(scheduler);
+        group.Run([] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        });
+        const auto cpu_before = thread_cpu_ns();
+        group.Wait();
+        assert(thread_cpu_ns() - cpu_before < 100'000'000);
+    }
+#endif
+    const size_t SIZE = 1'000'003;
+    Vector<uint32_t> values(SIZE, default_init);
+    uint32_t state = 12345;
+    for (auto& value : values) {
+        state = state * 1664525 + 1013904223;
+        value = state >> 8;
+    }
+    {
+        Vector<uint32_t> sorted = values;
+        ParallelSort(scheduler, sorted.begin(), sorted.end());
+        std::vector<uint32_t> expected(values.begin(), values.end());
+        std::sort(expected.begin(), expected.end());
+        assert(std::equal(sorted.begin(), sorted.end(), expected.begin(), expected.end()));
+        ParallelSort(scheduler, sorted.begin(), sorted.end(), std::greater<>());
+        assert(std::is_sorted(sorted.begin(), sorted.end(), std::greater<>()));
+        // Небольшие диапазоны сортируются в текущем потоке
+        Vector<std::string> names{"c", "a", "b"};
+        ParallelSort(names.begin(), names.end());
+        assert(names[0] == "a" && names[2] == "c");
+    }
+    {
+        Vector<uint64_t> doubled(SIZE, default_init);
+        const auto out = ParallelTransform(scheduler, values.begin(), values.end(), doubled.begin(), [](uint32_t value) {
+            return uint64_t{value} * 2;
+        });
+        assert(out == doubled.end());
+        for (size_t i = 0; i < SIZE; i += 997) {
+            assert(doubled[i] == uint64_t{values[i]} * 2);
+        }
+        const uint64_t sum = ParallelReduce(scheduler, values.begin(), values.end(), uint64_t{0});
+        uint64_t expected = 0;
+        for (const uint32_t value : values) {
+            expected += value;
+        }
+        assert(sum == expected);
+        assert(ParallelReduce(values.begin(), values.begin(), uint64_t{7}) == 7);
+        // Порядок объединения частичных результатов сохраняется
+        Vector<std::string> letters(SIZE / 10);
+        std::fill(letters.begin(), letters.end(), "a");
+        letters[0] = "x";
+        letters[letters.Size() - 1] = "y";
+        const std::string joined = ParallelReduce(scheduler, letters.begin(), letters.end(), std::string());
+        assert(joined.size() == letters.Size() && joined.front() == 'x' && joined.back() == 'y');
+
+        ParallelForEach(scheduler, doubled.begin(), doubled.end(), [](uint64_t& value) {
+            value /= 2;
+        });
+        assert(std::equal(doubled.begin(), doubled.end(), values.begin()));
+    }
+}
+
+int SumOf(std::span<const int> values) {
+    return std::accumulate(values.begin(), values.end(), 0);
+}
+
+void Test34() {
+    {
+        Vector<int> v{1, 2, 3};
+        assert(SumOf(v.AsSpan()) == 6);
+        std::span<int> span = v.AsSpan();
+        span[0] = 10;
+        assert(v[0] == 10 && span.data() == v.Data() && span.size() == v.Size());
+        assert(Vector<int>().AsSpan().empty());
+    }
+    // Внешний буфер принимается без копирования и освобождается своим deleter
+    const size_t CAPACITY = 4;
+    std::allocator<Obj> alloc;
+    size_t deleted = 0;
+    const auto deleter = [&](Obj* data, size_t capacity) {
+        assert(capacity == CAPACITY);
+        alloc.deallocate(data, capacity);
+        ++deleted;
+    };
+    Obj::ResetCounters();
+    {
+        Obj* buffer = alloc.allocate(CAPACITY);
+        new (buffer) Obj(1);
+        new (buffer + 1) Obj(2);
+        AdoptingVector<Obj> v = AdoptVector(buffer, 2, CAPACITY, BufferDeleter<Obj>(deleter));
+        assert(v.Data() == buffer && v.Size() == 2 && v.Capacity() == CAPACITY);
+        v.EmplaceBack(3);
+        assert(v.Data() == buffer && deleted == 0);
+    }
+    assert(deleted == 1 && Obj::GetAliveObjectCount() == 0 && Obj::num_copied == 0 && Obj::num_moved == 0);
+    {
+        // При реаллокации внешний буфер освобождается сразу, дальше память выделяет аллокатор
+        Obj* buffer = alloc.allocate(CAPACITY);
+        for (int i = 0; i < 4; ++i) {
+            new (buffer + i) Obj(i);
+        }
+        AdoptingVector<Obj> v = AdoptVector(buffer, 4, CAPACITY, BufferDeleter<Obj>(deleter));
+        v.EmplaceBack(4);
+        assert(deleted == 2 && v.Data() != buffer && v.Size() == 5 && v[0].id == 0 && v[4].id == 4);
+    }
+    {
+        // Буфер переходит вместе с аллокатором при перемещении, копия получает свою память
+        Obj* buffer = alloc.allocate(CAPACITY);
+        new (buffer) Obj(7);
+        AdoptingVector<Obj> v = AdoptVector(buffer, 1, CAPACITY, BufferDeleter<Obj>(deleter));
+        AdoptingVector<Obj> copy = v;
+        assert(copy.Data() != buffer && copy[0].id == 7);
+        AdoptingVector<Obj> moved;
+        moved = std::move(v);
+        assert(moved.Data() == buffer && deleted == 2);
+        moved = copy;
+        assert(moved.Data() == buffer && moved[0].id == 7);
+        moved.Swap(copy);
+        copy.Clear();
+        copy.ShrinkToFit();
+        assert(deleted == 3);
+    }
+    // Возможность принимать буферы не увеличивает обычный вектор
+    static_assert(VECTOR_CHECKED_ITERATORS || sizeof(Vector<int>) == 3 * sizeof(void*));
+    static_assert(sizeof(RawMemory<int>) == 2 * sizeof(void*));
+    assert(Obj::GetAliveObjectCount() == 0);
+    Obj::ResetCounters();
+    {
+        // Release и Adopt передают буфер между векторами без копирования элементов
+        Vector<Obj> source;
+        source.Reserve(8);
+        source.EmplaceBack(1);
+        source.EmplaceBack(2);
+        const Obj* data = source.Data();
+        ReleasedBuffer<Obj> released = source.Release();
+        assert(source.Size() == 0 && source.Capacity() == 0);
+        assert(released.data == data && released.size == 2 && released.capacity == 8);
+        Vector<Obj> target(adopt_buffer, released.data, released.size, released.capacity);
+        assert(target.Data() == data && target[1].id == 2);
+        // Отданный принятый буфер освобождается копией аллокатора вектора, то есть своим deleter
+        Obj* buffer = alloc.allocate(CAPACITY);
+        new (buffer) Obj(5);
+        AdoptingVector<Obj> adopted = AdoptVector(buffer, 1, CAPACITY, BufferDeleter<Obj>(deleter));
+        AdoptingAllocator<Obj> adopted_alloc = adopted.GetAllocator();
+        ReleasedBuffer<Obj> adopted_released = adopted.Release();
+        assert(adopted_released.data == buffer && adopted_released.size == 1);
+        std::destroy_n(adopted_released.data, adopted_released.size);
+        adopted_alloc.deallocate(adopted_released.data, adopted_released.capacity);
+        assert(deleted == 4);
+    }
+    assert(Obj::GetAliveObjectCount() == 0 && Obj::num_copied == 0);
+    {
+        // Элементы встроенного буфера переносятся в память аллокатора
+        SmallVector<std::string, 4> small{"a", "b"};
+        ReleasedBuffer<std::string> released = small.Release();
+        assert(small.Size() == 0 && released.size == 2 && released.data[1] == "b");
+        std::destroy_n(released.data, released.size);
+        std::allocator<std::string>().deallocate(released.data, released.capacity);
+        SmallVector<int, 4> empty;
+        assert(empty.Release().data == nullptr);
     }
 }
 
@@ -647,7 +2652,34 @@ int main() {
         Test4();
         Test5();
         Test6();
-        Benchmark();
+        Test7();
+        Test8();
+        Test9();
+        Test10();
+        Test11();
+        Test12();
+        Test13();
+        Test14();
+        Test15();
+        Test16();
+        Test17();
+        Test18();
+        Test19();
+        Test20();
+        Test21();
+        Test22();
+        Test23();
+        Test24();
+        Test25();
+        Test26();
+        Test27();
+        Test28();
+        Test29();
+        Test30();
+        Test31();
+        Test32();
+        Test33();
+        Test34();
     } catch (const std::exception& e) {
         std::cerr << e.what() << std::endl;
     }
@@ -0,0 +1,326 @@
+#pragma once
+
+#include "vector.h"
+
+// MappedVector опирается на mmap и доступен только на POSIX-системах; на остальных
+// платформах заголовок ничего не объявляет
+#if defined(__unix__)
+
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Вектор, элементы которого хранятся в отображённом в память файле (POSIX).
+// Open не читает и не копирует данные: страницы подгружаются при обращении, а
+// несколько процессов, открывших файл только для чтения, разделяют одни и те же страницы.
+// Файл начинается с заголовка (сигнатура, размер элемента, число элементов), дальше
+// лежат элементы; вместимость определяется размером файла. Изменения попадают в файл
+// через общие страницы, Sync дожидается их записи на диск.
+// Ошибки системных вызовов сообщаются через std::system_error, неверный формат
+// файла — через std::runtime_error
+template <typename T>
+class MappedVector {
+    static_assert(std::is_trivially_copyable_v<T>, "MappedVector requires trivially copyable elements");
+
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    enum class Mode {
+        READ_ONLY,
+        READ_WRITE,
+    };
+
+    // Создаёт новый файл (существующий перезаписывается) с местом для capacity элементов
+    static MappedVector Create(const std::string& path, size_t capacity = 0) {
+        const size_t length = FileLength(capacity);
+        MappedVector result(OpenFile(path, O_RDWR | O_CREAT | O_TRUNC), Mode::READ_WRITE);
+        result.ResizeFile(length);
+        Header& header = result.GetHeader();
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.element_size = sizeof(T);
+        header.size = 0;
+        return result;
+    }
+
+    static MappedVector Open(const std::string& path, Mode mode = Mode::READ_WRITE) {
+        MappedVector result(OpenFile(path, mode == Mode::READ_ONLY ? O_RDONLY : O_RDWR), mode);
+        struct stat st {};
+        if (fstat(result.fd_, &st) != 0) {
+            throw std::system_error(errno, std::generic_category(), "fstat " + path);
+        }
+        const auto length = static_cast<size_t>(st.st_size);
+        if (length < DATA_OFFSET) {
+            throw std::runtime_error("Not a MappedVector file: " + path);
+        }
+        result.Map(length);
+        const Header& header = result.GetHeader();
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.element_size != sizeof(T)
+            || header.size > result.Capacity()) {
+            throw std::runtime_error("Not a MappedVector file of this element type: " + path);
+        }
+        return result;
+    }
+
+    MappedVector(MappedVector&& other) noexcept
+        : fd_(std::exchange(other.fd_, -1))
+        , mapping_(std::exchange(other.mapping_, nullptr))
+        , length_(std::exchange(other.length_, 0))
+        , mode_(other.mode_) {
+    }
+
+    MappedVector& operator=(MappedVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Close();
+            fd_ = std::exchange(rhs.fd_, -1);
+            mapping_ = std::exchange(rhs.mapping_, nullptr);
+            length_ = std::exchange(rhs.length_, 0);
+            mode_ = rhs.mode_;
+        }
+        return *this;
+    }
+
+    MappedVector(const MappedVector&) = delete;
+    MappedVector& operator=(const MappedVector&) = delete;
+
+    ~MappedVector() {
+        Close();
+    }
+
+    // Неконстантный доступ к вектору, открытому только для чтения, приводит к std::logic_error:
+    // запись в отображение с PROT_READ завершила бы процесс. Читать такой вектор следует
+    // через константную ссылку (std::as_const, cbegin)
+    iterator begin() {
+        CheckWritable();
+        return Elements();
+    }
+
+    iterator end() {
+        CheckWritable();
+        return Elements() + Size();
+    }
+
+    const_iterator begin() const noexcept {
+        return Elements();
+    }
+
+    const_iterator end() const noexcept {
+        return Elements() + Size();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    size_t Size() const noexcept {
+        return mapping_ != nullptr ? GetHeader().size : 0;
+    }
+
+    size_t Capacity() const noexcept {
+        return length_ > DATA_OFFSET ? (length_ - DATA_OFFSET) / sizeof(T) : 0;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < Size());
+        return Elements()[index];
+    }
+
+    T& operator[](size_t index) {
+        CheckWritable();
+        assert(index < Size());
+        return Elements()[index];
+    }
+
+    // Увеличивает файл через ftruncate и расширяет отображение
+    void Reserve(size_t new_capacity) {
+        CheckWritable();
+        if (new_capacity <= Capacity()) {
+            return;
+        }
+        ResizeFile(FileLength(new_capacity));
+    }
+
+    void Resize(size_t new_size) {
+        CheckWritable();
+        Reserve(new_size);
+        if (new_size > Size()) {
+            std::uninitialized_value_construct_n(Elements() + Size(), new_size - Size());
+        }
+        GetHeader().size = new_size;
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        CheckWritable();
+        // Значение создаётся до роста: аргументы могут ссылаться на элементы вектора
+        T value(std::forward<Args>(args)...);
+        const size_t size = Size();
+        if (size == Capacity()) {
+            Reserve(DoublingGrowth<>::NextCapacity(size, sizeof(T)));
+        }
+        T* result = new (Elements() + size) T(value);
+        GetHeader().size = size + 1;
+        return *result;
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PopBack() {
+        CheckWritable();
+        assert(Size() > 0);
+        --GetHeader().size;
+    }
+
+    void Clear() {
+        CheckWritable();
+        GetHeader().size = 0;
+    }
+
+    // Дожидается записи изменённых страниц в файл
+    void Sync() {
+        if (mode_ == Mode::READ_WRITE && msync(mapping_, length_, MS_SYNC) != 0) {
+            throw std::system_error(errno, std::generic_category(), "msync");
+        }
+    }
+
+    bool IsReadOnly() const noexcept {
+        return mode_ == Mode::READ_ONLY;
+    }
+
+private:
+    struct Header {
+        char magic[8];
+        uint64_t element_size;
+        uint64_t size;
+    };
+
+    static constexpr char MAGIC[8] = {'M', 'A', 'P', 'V', 'E', 'C', '0', '1'};
+    // Элементы начинаются с границы кэш-линии
+    static constexpr size_t DATA_OFFSET = 64;
+    static_assert(sizeof(Header) <= DATA_OFFSET && alignof(T) <= DATA_OFFSET);
+
+    int fd_ = -1;
+    void* mapping_ = nullptr;
+    size_t length_ = 0;
+    Mode mode_ = Mode::READ_ONLY;
+
+    MappedVector(int fd, Mode mode) noexcept
+        : fd_(fd)
+        , mode_(mode) {
+    }
+
+    // Длина файла с местом для capacity элементов
+    static size_t FileLength(size_t capacity) {
+        if (capacity > (SIZE_MAX - DATA_OFFSET) / sizeof(T)) {
+            throw std::length_error("MappedVector capacity is too large");
+        }
+        return DATA_OFFSET + capacity * sizeof(T);
+    }
+
+    static int OpenFile(const std::string& path, int flags) {
+        const int fd = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "open " + path);
+        }
+        return fd;
+    }
+
+    Header& GetHeader() noexcept {
+        return *static_cast<Header*>(mapping_);
+    }
+
+    const Header& GetHeader() const noexcept {
+        return *static_cast<const Header*>(mapping_);
+    }
+
+    T* Elements() noexcept {
+        return mapping_ != nullptr ? reinterpret_cast<T*>(static_cast<std::byte*>(mapping_) + DATA_OFFSET) : nullptr;
+    }
+
+    const T* Elements() const noexcept {
+        return mapping_ != nullptr ? reinterpret_cast<const T*>(static_cast<const std::byte*>(mapping_) + DATA_OFFSET)
+                                   : nullptr;
+    }
+
+    void CheckWritable() const {
+        if (mode_ == Mode::READ_ONLY) {
+            throw std::logic_error("MappedVector is opened read-only");
+        }
+    }
+
+    void Map(size_t length) {
+        const int protection = mode_ == Mode::READ_ONLY ? PROT_READ : PROT_READ | PROT_WRITE;
+        void* mapping = mmap(nullptr, length, protection, MAP_SHARED, fd_, 0);
+        if (mapping == MAP_FAILED) {
+            throw std::system_error(errno, std::generic_category(), "mmap");
+        }
+        mapping_ = mapping;
+        length_ = length;
+    }
+
+    // Делает файл длиной length байт и отображает его целиком. Если расширить
+    // отображение не удалось, прежний размер файла восстанавливается
+    void ResizeFile(size_t length) {
+        if (ftruncate(fd_, static_cast<off_t>(length)) != 0) {
+            throw std::system_error(errno, std::generic_category(), "ftruncate");
+        }
+        if (mapping_ == nullptr) {
+            Map(length);
+            return;
+        }
+#ifdef __linux__
+        void* mapping = mremap(mapping_, length_, length, MREMAP_MAYMOVE);
+        if (mapping == MAP_FAILED) {
+            const int error = errno;
+            [[maybe_unused]] const int rc = ftruncate(fd_, static_cast<off_t>(length_));
+            throw std::system_error(error, std::generic_category(), "mremap");
+        }
+        mapping_ = mapping;
+        length_ = length;
+#else
+        void* old_mapping = mapping_;
+        const size_t old_length = length_;
+        try {
+            Map(length);
+        } catch (...) {
+            [[maybe_unused]] const int rc = ftruncate(fd_, static_cast<off_t>(old_length));
+            throw;
+        }
+        munmap(old_mapping, old_length);
+#endif
+    }
+
+    void Close() noexcept {
+        if (mapping_ != nullptr) {
+            munmap(mapping_, length_);
+            mapping_ = nullptr;
+            length_ = 0;
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+};
+
+#endif  // defined(__unix__)
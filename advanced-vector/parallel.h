@@ -0,0 +1,481 @@
+#pragma once
+
+#include "vector.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+
+// Параллельные алгоритмы над диапазонами Vector без TBB и <execution>: небольшой
+// планировщик с кражей задач и ParallelForEach, ParallelTransform, ParallelReduce, ParallelSort.
+// Границы участков выравниваются по кэш-линиям записываемого диапазона, чтобы потоки
+// не писали в одну линию
+
+inline constexpr size_t CACHE_LINE_SIZE = 64;
+
+class TaskScheduler;
+
+// Группа задач, завершения которых можно дождаться. Ожидающий поток не простаивает,
+// а выполняет задачи планировщика, поэтому группы можно вкладывать: задача может
+// запустить свою группу и ждать её. Когда свободных задач нет, ожидающий поток засыпает
+// до завершения группы или появления новой задачи
+class TaskGroup {
+public:
+    explicit TaskGroup(TaskScheduler& scheduler);
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    ~TaskGroup() {
+        WaitAll();
+    }
+
+    template <typename Function>
+    void Run(Function&& fn);
+
+    // Дожидается всех задач группы и пробрасывает первое исключение, выброшенное задачей
+    void Wait() {
+        WaitAll();
+        if (error_ != nullptr) {
+            std::rethrow_exception(std::exchange(error_, nullptr));
+        }
+    }
+
+private:
+    friend class TaskScheduler;
+
+    TaskScheduler& scheduler_;
+    std::atomic<size_t> pending_ = 0;
+    std::mutex error_mutex_;
+    std::exception_ptr error_;
+
+    void WaitAll() noexcept;
+
+    void OnFinished(std::exception_ptr error) noexcept;
+};
+
+// Пул потоков с очередью задач у каждого потока. Поток берёт свои задачи с конца очереди,
+// где лежат самые свежие, а когда его очередь пуста, забирает старые задачи из начала
+// чужих очередей. Задачи, запущенные не из рабочих потоков, распределяются по очередям
+// по кругу
+class TaskScheduler {
+public:
+    // threads == 0 — по числу аппаратных потоков
+    explicit TaskScheduler(size_t threads = 0) {
+        const size_t count = threads != 0 ? threads : std::max(std::thread::hardware_concurrency(), 1u);
+        queues_.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            queues_.push_back(std::make_unique<Queue>());
+        }
+        workers_.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            workers_.emplace_back([this, i] {
+                WorkerLoop(i);
+            });
+        }
+    }
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    ~TaskScheduler() {
+        {
+            std::lock_guard lock(sleep_mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        workers_.clear();
+    }
+
+    static TaskScheduler& Default() {
+        static TaskScheduler scheduler;
+        return scheduler;
+    }
+
+    size_t WorkerCount() const noexcept {
+        return queues_.size();
+    }
+
+private:
+    friend class TaskGroup;
+
+    struct Task {
+        std::function<void()> fn;
+        TaskGroup* group;
+    };
+
+    // Очереди на отдельных кэш-линиях, чтобы блокировки соседних потоков не мешали друг другу
+    struct alignas(CACHE_LINE_SIZE) Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    // Увеличивается до помещения задачи в очередь и уменьшается после её извлечения,
+    // поэтому не меньше числа задач в очередях и никогда не уходит ниже нуля
+    std::atomic<size_t> queued_ = 0;
+    std::atomic<size_t> next_queue_ = 0;
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    std::vector<std::jthread> workers_;
+
+    inline static thread_local const TaskScheduler* current_ = nullptr;
+    inline static thread_local size_t current_index_ = 0;
+
+    size_t HomeQueue() noexcept {
+        if (current_ == this) {
+            return current_index_;
+        }
+        return next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    }
+
+    void Push(Task task) {
+        Queue& queue = *queues_[HomeQueue()];
+        queued_.fetch_add(1, std::memory_order_relaxed);
+        try {
+            std::lock_guard lock(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        } catch (...) {
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            throw;
+        }
+        {
+            // Без захвата мьютекса засыпающий поток мог бы пропустить уведомление
+            std::lock_guard lock(sleep_mutex_);
+        }
+        wake_.notify_one();
+    }
+
+    std::optional<Task> Pop(size_t home) {
+        for (size_t k = 0; k < queues_.size(); ++k) {
+            Queue& queue = *queues_[(home + k) % queues_.size()];
+            std::lock_guard lock(queue.mutex);
+            if (queue.tasks.empty()) {
+                continue;
+            }
+            std::optional<Task> task;
+            if (k == 0) {
+                task.emplace(std::move(queue.tasks.back()));
+                queue.tasks.pop_back();
+            } else {
+                task.emplace(std::move(queue.tasks.front()));
+                queue.tasks.pop_front();
+            }
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            return task;
+        }
+        return std::nullopt;
+    }
+
+    // Выполняет одну задачу, если она есть
+    bool TryRunOne() {
+        std::optional<Task> task = Pop(current_ == this ? current_index_ : 0);
+        if (!task) {
+            return false;
+        }
+        std::exception_ptr error;
+        try {
+            task->fn();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        task->group->OnFinished(std::move(error));
+        return true;
+    }
+
+    // Усыпляет поток, ожидающий группу, пока она не завершится или не появится задача
+    void WaitForGroup(const std::atomic<size_t>& pending) {
+        std::unique_lock lock(sleep_mutex_);
+        wake_.wait(lock, [this, &pending] {
+            return pending.load(std::memory_order_acquire) == 0 || queued_.load(std::memory_order_relaxed) != 0;
+        });
+    }
+
+    // Будит потоки, ожидающие групп. Планировщик переживает группы, поэтому уведомление
+    // безопасно и после того, как ожидающий поток уничтожил завершённую группу
+    void NotifyGroupFinished() noexcept {
+        {
+            std::lock_guard lock(sleep_mutex_);
+        }
+        wake_.notify_all();
+    }
+
+    void WorkerLoop(size_t index) {
+        current_ = this;
+        current_index_ = index;
+        while (true) {
+            if (TryRunOne()) {
+                continue;
+            }
+            std::unique_lock lock(sleep_mutex_);
+            wake_.wait(lock, [this] {
+                return stopping_ || queued_.load(std::memory_order_relaxed) != 0;
+            });
+            if (stopping_) {
+                return;
+            }
+        }
+    }
+};
+
+inline TaskGroup::TaskGroup(TaskScheduler& scheduler)
+    : scheduler_(scheduler) {
+}
+
+template <typename Function>
+void TaskGroup::Run(Function&& fn) {
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    try {
+        scheduler_.Push({std::function<void()>(std::forward<Function>(fn)), this});
+    } catch (...) {
+        pending_.fetch_sub(1, std::memory_order_relaxed);
+        throw;
+    }
+}
+
+inline void TaskGroup::OnFinished(std::exception_ptr error) noexcept {
+    if (error != nullptr) {
+        std::lock_guard lock(error_mutex_);
+        if (error_ == nullptr) {
+            error_ = std::move(error);
+        }
+    }
+    // После последнего уменьшения группа может быть уже уничтожена ожидающим потоком
+    TaskScheduler& scheduler = scheduler_;
+    if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        scheduler.NotifyGroupFinished();
+    }
+}
+
+inline void TaskGroup::WaitAll() noexcept {
+    while (pending_.load(std::memory_order_acquire) != 0) {
+        if (!scheduler_.TryRunOne()) {
+            scheduler_.WaitForGroup(pending_);
+        }
+    }
+}
+
+// Делит [0, n) на участки не меньше min_chunk элементов, границы которых (кроме крайних)
+// приходятся на начала кэш-линий диапазона data, и вызывает fn(first, count) для каждого
+// участка в задачах планировщика. Небольшие диапазоны обрабатываются в текущем потоке
+template <typename T, typename Function>
+void ForEachAlignedChunk(TaskScheduler& scheduler, const T* data, size_t n, size_t min_chunk, Function fn) {
+    const size_t target_chunks = scheduler.WorkerCount() * 4;
+    if (n < 2 * min_chunk || scheduler.WorkerCount() < 2) {
+        fn(size_t{0}, n);
+        return;
+    }
+    size_t chunk = std::max(min_chunk, (n + target_chunks - 1) / target_chunks);
+    size_t head = 0;
+    if constexpr (CACHE_LINE_SIZE % sizeof(T) == 0) {
+        constexpr size_t PER_LINE = CACHE_LINE_SIZE / sizeof(T);
+        chunk = (chunk + PER_LINE - 1) / PER_LINE * PER_LINE;
+        const auto address = reinterpret_cast<std::uintptr_t>(data);
+        if (address % sizeof(T) == 0) {
+            head = (CACHE_LINE_SIZE - address % CACHE_LINE_SIZE) % CACHE_LINE_SIZE / sizeof(T);
+        }
+    }
+    TaskGroup group(scheduler);
+    size_t first = 0;
+    while (first < n) {
+        const size_t count = std::min(n - first, first == 0 ? head + chunk : chunk);
+        group.Run([&fn, first, count] {
+            fn(first, count);
+        });
+        first += count;
+    }
+    group.Wait();
+}
+
+// Участки меньше PARALLEL_MIN_CHUNK_BYTES не выделяются в отдельные задачи
+inline constexpr size_t PARALLEL_MIN_CHUNK_BYTES = size_t{64} << 10;
+
+template <typename T>
+constexpr size_t ParallelMinChunk() noexcept {
+    return std::max<size_t>(PARALLEL_MIN_CHUNK_BYTES / sizeof(T), 1);
+}
+
+template <std::contiguous_iterator It, typename Function>
+void ParallelForEach(TaskScheduler& scheduler, It first, It last, Function fn) {
+    using Value = std::iter_value_t<It>;
+    ForEachAlignedChunk(scheduler, std::to_address(first), static_cast<size_t>(last - first),
+                        ParallelMinChunk<Value>(), [first, &fn](size_t begin, size_t count) {
+                            std::for_each(first + begin, first + (begin + count), fn);
+                        });
+}
+
+template <std::contiguous_iterator It, typename Function>
+void ParallelForEach(It first, It last, Function fn) {
+    ParallelForEach(TaskScheduler::Default(), first, last, std::move(fn));
+}
+
+// Участки выравниваются по выходному диапазону, в который пишут задачи
+template <std::contiguous_iterator InputIt, std::contiguous_iterator OutputIt, typename Operation>
+OutputIt ParallelTransform(TaskScheduler& scheduler, InputIt first, InputIt last, OutputIt out, Operation op) {
+    using Value = std::iter_value_t<OutputIt>;
+    const auto n = static_cast<size_t>(last - first);
+    ForEachAlignedChunk(scheduler, std::to_address(out), n, ParallelMinChunk<Value>(),
+                        [first, out, &op](size_t begin, size_t count) {
+                            std::transform(first + begin, first + (begin + count), out + begin, op);
+                        });
+    return out + n;
+}
+
+template <std::contiguous_iterator InputIt, std::contiguous_iterator OutputIt, typename Operation>
+OutputIt ParallelTransform(InputIt first, InputIt last, OutputIt out, Operation op) {
+    return ParallelTransform(TaskScheduler::Default(), first, last, out, std::move(op));
+}
+
+// Свёртка ассоциативной операцией op. Частичные результаты участков лежат на отдельных
+// кэш-линиях и объединяются в порядке участков, поэтому коммутативность op не требуется
+template <std::contiguous_iterator It, typename T, typename BinaryOperation = std::plus<>>
+T ParallelReduce(TaskScheduler& scheduler, It first, It last, T init, BinaryOperation op = {}) {
+    struct alignas(CACHE_LINE_SIZE) Partial {
+        std::optional<T> value;
+    };
+    using Value = std::iter_value_t<It>;
+    const auto n = static_cast<size_t>(last - first);
+    if (n == 0) {
+        return init;
+    }
+    const size_t min_chunk = ParallelMinChunk<Value>();
+    // Все участки, кроме первого, не короче min_chunk
+    Vector<Partial> partials(n / std::max<size_t>(min_chunk, 1) + 2);
+    std::atomic<size_t> next_partial = 0;
+    Vector<size_t> starts(partials.Size());
+    ForEachAlignedChunk(scheduler, std::to_address(first), n, min_chunk,
+                        [&](size_t begin, size_t count) {
+                            T acc = static_cast<T>(first[begin]);
+                            for (size_t i = begin + 1; i < begin + count; ++i) {
+                                acc = op(std::move(acc), first[i]);
+                            }
+                            const size_t slot = next_partial.fetch_add(1, std::memory_order_relaxed);
+                            partials[slot].value.emplace(std::move(acc));
+                            starts[slot] = begin;
+                        });
+    // Участки завершаются в произвольном порядке, поэтому частичные результаты упорядочиваются
+    const size_t count = next_partial.load();
+    Vector<size_t> order(count);
+    for (size_t i = 0; i < count; ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&starts](size_t lhs, size_t rhs) {
+        return starts[lhs] < starts[rhs];
+    });
+    for (const size_t slot : order) {
+        init = op(std::move(init), std::move(*partials[slot].value));
+    }
+    return init;
+}
+
+template <std::contiguous_iterator It, typename T, typename BinaryOperation = std::plus<>>
+T ParallelReduce(It first, It last, T init, BinaryOperation op = {}) {
+    return ParallelReduce(TaskScheduler::Default(), first, last, std::move(init), std::move(op));
+}
+
+// Параллельная сортировка слиянием: участки сортируются std::sort, затем соседние серии
+// сливаются попарно за log2(число участков) проходов через буфер. Каждое слияние делится
+// на независимые части поиском точек разбиения (merge path), так что и последние проходы
+// выполняются всеми потоками. Сортировка не устойчива. При исключении из comp содержимое
+// диапазона не определено, но все элементы остаются в корректном состоянии
+template <std::contiguous_iterator It, typename Compare = std::less<>>
+    requires std::default_initializable<std::iter_value_t<It>> && std::movable<std::iter_value_t<It>>
+void ParallelSort(TaskScheduler& scheduler, It first, It last, Compare comp = {}) {
+    using Value = std::iter_value_t<It>;
+    const auto n = static_cast<size_t>(last - first);
+    const size_t min_chunk = ParallelMinChunk<Value>();
+    // С одним рабочим потоком слияние только добавило бы проход по данным
+    size_t runs = scheduler.WorkerCount() < 2 ? 1 : std::bit_ceil(scheduler.WorkerCount() * 2);
+    while (runs > 1 && n / runs < min_chunk) {
+        runs /= 2;
+    }
+    Value* data = std::to_address(first);
+    if (runs <= 1) {
+        std::sort(data, data + n, comp);
+        return;
+    }
+    Vector<size_t> bounds(runs + 1);
+    for (size_t i = 0; i <= runs; ++i) {
+        bounds[i] = n / runs * i + std::min(i, n % runs);
+    }
+    {
+        TaskGroup group(scheduler);
+        for (size_t i = 0; i < runs; ++i) {
+            group.Run([data, &bounds, &comp, i] {
+                std::sort(data + bounds[i], data + bounds[i + 1], comp);
+            });
+        }
+        group.Wait();
+    }
+
+    Vector<Value> buffer(n, default_init);
+    Value* src = data;
+    Value* dst = buffer.Data();
+    for (size_t width = 1; width < runs; width *= 2) {
+        TaskGroup group(scheduler);
+        for (size_t i = 0; i < runs; i += 2 * width) {
+            const size_t left = bounds[i];
+            const size_t middle = bounds[i + width];
+            const size_t right = bounds[i + 2 * width];
+            const size_t total = right - left;
+            const size_t pieces = std::max<size_t>(total / min_chunk, 1);
+            for (size_t piece = 0; piece < pieces; ++piece) {
+                const size_t out_first = total * piece / pieces;
+                const size_t out_last = total * (piece + 1) / pieces;
+                group.Run([=, &comp] {
+                    const Value* a = src + left;
+                    const Value* b = src + middle;
+                    const size_t a_size = middle - left;
+                    const size_t b_size = right - middle;
+                    // Сколько элементов первой серии попадает в первые k элементов результата
+                    auto split = [&](size_t k) {
+                        size_t lo = k > b_size ? k - b_size : 0;
+                        size_t hi = std::min(k, a_size);
+                        while (lo < hi) {
+                            const size_t mid = lo + (hi - lo) / 2;
+                            if (comp(b[k - mid - 1], a[mid])) {
+                                hi = mid;
+                            } else {
+                                lo = mid + 1;
+                            }
+                        }
+                        return lo;
+                    };
+                    const size_t a_first = split(out_first);
+                    const size_t a_last = split(out_last);
+                    std::merge(std::make_move_iterator(src + left + a_first),
+                               std::make_move_iterator(src + left + a_last),
+                               std::make_move_iterator(src + middle + (out_first - a_first)),
+                               std::make_move_iterator(src + middle + (out_last - a_last)), dst + left + out_first,
+                               comp);
+                });
+            }
+        }
+        group.Wait();
+        std::swap(src, dst);
+    }
+    if (src != data) {
+        ParallelTransform(scheduler, src, src + n, data, [](Value& value) -> Value&& {
+            return std::move(value);
+        });
+    }
+}
+
+template <std::contiguous_iterator It, typename Compare = std::less<>>
+    requires std::default_initializable<std::iter_value_t<It>> && std::movable<std::iter_value_t<It>>
+void ParallelSort(It first, It last, Compare comp = {}) {
+    ParallelSort(TaskScheduler::Default(), first, last, std::move(comp));
+}
@@ -0,0 +1,486 @@
+#include "vector.h"
+#include "benchmark_utils.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+// Регрессионный набор Vector. Первая часть проверяет, сколько копирований и перемещений
+// делает каждая операция для типов с разными свойствами перемещения: так обнаруживается
+// потеря быстрого пути переноса элементов. Вторая часть замеряет время операций и сравнивает
+// его с базовым замером из JSON-файла.
+// Запуск: regression [--baseline=файл.json] [--update] [--threshold=K] [--min-time-ms=M]
+//                   [--min-regression-ns=D]
+// С --update замеры записываются в файл как новый базовый уровень. Без него программа
+// завершается с ошибкой, если операция стала медленнее базового замера больше чем в K раз
+// и при этом больше чем на D наносекунд: доли наносекунды на элемент — это шум таймера
+
+namespace {
+
+using namespace std::literals;
+
+// Счётчики специальных функций-членов всех типов Counted
+struct Counts {
+    size_t copies = 0;
+    size_t moves = 0;
+    size_t copy_assigns = 0;
+    size_t move_assigns = 0;
+
+    bool operator==(const Counts&) const = default;
+};
+
+Counts counts;
+
+std::ostream& operator<<(std::ostream& out, const Counts& c) {
+    return out << "{copies=" << c.copies << " moves=" << c.moves << " copy_assigns=" << c.copy_assigns
+               << " move_assigns=" << c.move_assigns << '}';
+}
+
+// Элемент, считающий свои копирования и перемещения. NothrowMove задаёт спецификацию
+// noexcept перемещения, Copyable — наличие копирования. Relocatable помечает тип
+// тривиально перемещаемым (см. специализацию IsTriviallyRelocatable ниже)
+template <bool NothrowMove, bool Copyable, bool Relocatable = false>
+class Counted {
+public:
+    Counted() = default;
+
+    explicit Counted(int value) noexcept
+        : value_(value) {
+    }
+
+    Counted(const Counted& other) noexcept
+        requires Copyable
+        : value_(other.value_) {
+        ++counts.copies;
+    }
+
+    Counted(Counted&& other) noexcept(NothrowMove)
+        : value_(other.value_) {
+        ++counts.moves;
+    }
+
+    Counted& operator=(const Counted& rhs) noexcept
+        requires Copyable
+    {
+        value_ = rhs.value_;
+        ++counts.copy_assigns;
+        return *this;
+    }
+
+    Counted& operator=(Counted&& rhs) noexcept(NothrowMove) {
+        value_ = rhs.value_;
+        ++counts.move_assigns;
+        return *this;
+    }
+
+    int Value() const noexcept {
+        return value_;
+    }
+
+private:
+    int value_ = 0;
+};
+
+using NothrowMovable = Counted<true, true>;
+// Перемещение может выбросить исключение: для строгой гарантии при реаллокации элементы копируются
+using ThrowingMovable = Counted<false, true>;
+// Копирования нет, поэтому элементы перемещаются, несмотря на возможное исключение
+using MoveOnly = Counted<false, false>;
+// Переносится memcpy без вызова конструкторов
+using Relocatable = Counted<false, true, true>;
+
+}  // namespace
+
+template <bool NothrowMove, bool Copyable>
+struct IsTriviallyRelocatable<Counted<NothrowMove, Copyable, true>> : std::true_type {};
+
+namespace {
+
+// Способ, которым Vector обязан переносить элементы типа T в новый буфер
+enum class Transfer { MEMCPY, MOVE, COPY };
+
+template <typename T>
+constexpr Transfer ExpectedTransfer() {
+    if constexpr (IsTriviallyRelocatableV<T>) {
+        return Transfer::MEMCPY;
+    } else if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+        return Transfer::MOVE;
+    } else {
+        return Transfer::COPY;
+    }
+}
+
+// Счётчики переноса n элементов в новый буфер
+template <typename T>
+Counts Transferred(size_t n) {
+    switch (ExpectedTransfer<T>()) {
+        case Transfer::MOVE:
+            return {.moves = n};
+        case Transfer::COPY:
+            return {.copies = n};
+        default:
+            return {};
+    }
+}
+
+Counts operator+(Counts lhs, const Counts& rhs) {
+    lhs.copies += rhs.copies;
+    lhs.moves += rhs.moves;
+    lhs.copy_assigns += rhs.copy_assigns;
+    lhs.move_assigns += rhs.move_assigns;
+    return lhs;
+}
+
+// Размер вектора в проверках счётчиков
+constexpr size_t SIZE = 1'000;
+constexpr size_t MIDDLE = SIZE / 2;
+
+// Вектор из SIZE элементов со значениями 0, 1, ..., вместимость которого ровно SIZE
+template <typename T>
+Vector<T> MakeFull() {
+    Vector<T> v;
+    v.Reserve(SIZE);
+    for (size_t i = 0; i < SIZE; ++i) {
+        v.EmplaceBack(static_cast<int>(i));
+    }
+    return v;
+}
+
+int failures = 0;
+
+// Выполняет operation над вектором, созданным prepare, и сравнивает приращение
+// счётчиков с ожидаемым. Подготовка и уничтожение векторов в счётчики не попадают
+template <typename Prepare, typename Operation>
+void CheckCounts(std::string_view name, const Counts& expected, Prepare&& prepare, Operation&& operation) {
+    auto v = prepare();
+    counts = {};
+    operation(v);
+    const Counts actual = counts;
+    if (actual != expected) {
+        ++failures;
+        std::cout << "FAIL " << name << ": expected " << expected << ", got " << actual << '\n';
+    } else {
+        std::cout << "ok   " << name << '\n';
+    }
+}
+
+template <typename T>
+void CheckAllCounts(std::string_view type_name) {
+    const auto name = [type_name](std::string_view operation) {
+        return std::string(operation) + '/' + std::string(type_name);
+    };
+    // Ёмкость, вдвое большая размера
+    const auto make_spare = [] {
+        Vector<T> v = MakeFull<T>();
+        v.Reserve(SIZE * 2);
+        return v;
+    };
+    // Сдвиг хвоста внутри буфера выполняется перемещением для всех нетривиально перемещаемых типов
+    const bool relocatable = ExpectedTransfer<T>() == Transfer::MEMCPY;
+
+    CheckCounts(name("Reserve"), Transferred<T>(SIZE), MakeFull<T>, [](Vector<T>& v) {
+        v.Reserve(SIZE * 2);
+    });
+    CheckCounts(name("ShrinkToFit"), Transferred<T>(SIZE), make_spare, [](Vector<T>& v) {
+        v.ShrinkToFit();
+    });
+    CheckCounts(name("Resize(grow)"), Transferred<T>(SIZE), MakeFull<T>, [](Vector<T>& v) {
+        v.Resize(SIZE * 2);
+    });
+    CheckCounts(name("EmplaceBack(realloc)"), Transferred<T>(SIZE), MakeFull<T>, [](Vector<T>& v) {
+        v.EmplaceBack(-1);
+    });
+    CheckCounts(name("PushBack(rvalue, realloc)"), Transferred<T>(SIZE) + Counts{.moves = 1}, MakeFull<T>,
+                [](Vector<T>& v) {
+                    v.PushBack(T(-1));
+                });
+    CheckCounts(name("Emplace(middle, realloc)"), Transferred<T>(SIZE), MakeFull<T>, [](Vector<T>& v) {
+        v.Emplace(v.cbegin() + MIDDLE, -1);
+    });
+    CheckCounts(name("Insert(middle, rvalue, realloc)"), Transferred<T>(SIZE) + Counts{.moves = 1}, MakeFull<T>,
+                [](Vector<T>& v) {
+                    v.Insert(v.cbegin() + MIDDLE, T(-1));
+                });
+    CheckCounts(name("Emplace(middle)"),
+                relocatable ? Counts{} : Counts{.moves = 1, .move_assigns = SIZE - MIDDLE}, make_spare,
+                [](Vector<T>& v) {
+                    v.Emplace(v.cbegin() + MIDDLE, -1);
+                });
+    CheckCounts(name("Erase(middle)"), relocatable ? Counts{} : Counts{.move_assigns = SIZE - MIDDLE - 1},
+                MakeFull<T>, [](Vector<T>& v) {
+                    v.Erase(v.cbegin() + MIDDLE);
+                });
+    CheckCounts(name("MoveConstruct"), Counts{}, MakeFull<T>, [](Vector<T>& v) {
+        Vector<T> moved(std::move(v));
+        DoNotOptimize(moved);
+    });
+    CheckCounts(name("MoveAssign"), Counts{}, MakeFull<T>, [](Vector<T>& v) {
+        Vector<T> moved;
+        moved = std::move(v);
+        DoNotOptimize(moved);
+    });
+    CheckCounts(name("Swap"), Counts{}, MakeFull<T>, [](Vector<T>& v) {
+        Vector<T> other = MakeFull<T>();
+        counts = {};
+        v.Swap(other);
+    });
+
+    if constexpr (std::is_copy_constructible_v<T>) {
+        CheckCounts(name("PushBack(lvalue, realloc)"), Transferred<T>(SIZE) + Counts{.copies = 1}, MakeFull<T>,
+                    [](Vector<T>& v) {
+                        const T value(-1);
+                        v.PushBack(value);
+                    });
+        CheckCounts(name("Insert(middle, 10 copies, realloc)"), Transferred<T>(SIZE) + Counts{.copies = 10},
+                    MakeFull<T>, [](Vector<T>& v) {
+                        const T value(-1);
+                        v.Insert(v.cbegin() + MIDDLE, 10, value);
+                    });
+        CheckCounts(name("CopyConstruct"), Counts{.copies = SIZE}, MakeFull<T>, [](Vector<T>& v) {
+            Vector<T> copy(v);
+            DoNotOptimize(copy);
+        });
+    }
+}
+
+struct Options {
+    std::string baseline;
+    bool update = false;
+    double threshold = 1.5;
+    double min_regression_ns = 1.0;
+    std::chrono::milliseconds min_time{50};
+};
+
+// Число повторных замеров; в отчёт идёт наименьший, наименее подверженный шуму
+constexpr int REPETITIONS = 3;
+
+// Количество элементов в замерах времени
+constexpr size_t TIMED_SIZE = 10'000;
+
+// Число векторов, обрабатываемых за один замер в быстрых операциях над всем вектором:
+// один Reserve или копирование занимает единицы микросекунд, сравнимые с погрешностью часов
+constexpr size_t BATCH = 16;
+
+using Timings = std::map<std::string, double>;
+
+template <typename T>
+void MeasureAll(const Options& options, std::string_view type_name, Timings& timings) {
+    const auto measure = [&](std::string_view operation, auto run) {
+        double best = 0.0;
+        for (int i = 0; i < REPETITIONS; ++i) {
+            const double ns = MeasureNsPerOp(options.min_time, run);
+            best = i == 0 ? ns : std::min(best, ns);
+        }
+        timings[std::string(operation) + '/' + std::string(type_name)] = best;
+    };
+    const auto make_filled = [] {
+        Vector<T> v;
+        v.Reserve(TIMED_SIZE);
+        for (size_t i = 0; i < TIMED_SIZE; ++i) {
+            v.EmplaceBack(MakeValue<T>(i));
+        }
+        return v;
+    };
+
+    measure("PushBack"sv, [](Stopwatch& stopwatch) {
+        const T value = MakeValue<T>(1);
+        stopwatch.Start();
+        Vector<T> v;
+        for (size_t i = 0; i < TIMED_SIZE; ++i) {
+            v.PushBack(value);
+        }
+        DoNotOptimize(v);
+        stopwatch.Stop();
+        return TIMED_SIZE;
+    });
+    measure("Reserve(x2)"sv, [&](Stopwatch& stopwatch) {
+        Vector<Vector<T>> batch;
+        batch.Reserve(BATCH);
+        for (size_t i = 0; i < BATCH; ++i) {
+            batch.PushBack(make_filled());
+        }
+        stopwatch.Start();
+        for (Vector<T>& v : batch) {
+            v.Reserve(TIMED_SIZE * 2);
+            DoNotOptimize(v);
+        }
+        stopwatch.Stop();
+        return TIMED_SIZE * BATCH;
+    });
+    measure("Insert(middle)"sv, [&](Stopwatch& stopwatch) {
+        Vector<T> v = make_filled();
+        const T value = MakeValue<T>(1);
+        stopwatch.Start();
+        for (size_t i = 0; i < 100; ++i) {
+            v.Insert(v.cbegin() + v.Size() / 2, value);
+        }
+        DoNotOptimize(v);
+        stopwatch.Stop();
+        return size_t{100};
+    });
+    measure("Erase(middle)"sv, [&](Stopwatch& stopwatch) {
+        Vector<T> v = make_filled();
+        stopwatch.Start();
+        for (size_t i = 0; i < 100; ++i) {
+            v.Erase(v.cbegin() + v.Size() / 2);
+        }
+        DoNotOptimize(v);
+        stopwatch.Stop();
+        return size_t{100};
+    });
+    measure("CopyConstruct"sv, [&](Stopwatch& stopwatch) {
+        const Vector<T> source = make_filled();
+        Vector<Vector<T>> copies;
+        copies.Reserve(BATCH);
+        stopwatch.Start();
+        for (size_t i = 0; i < BATCH; ++i) {
+            copies.PushBack(source);
+        }
+        DoNotOptimize(copies);
+        stopwatch.Stop();
+        return TIMED_SIZE * BATCH;
+    });
+}
+
+// Базовый замер хранится плоским JSON-объектом {"операция/тип": нс на операцию, ...}
+Timings ReadBaseline(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Cannot open baseline "s + path);
+    }
+    std::stringstream content;
+    content << in.rdbuf();
+    const std::string text = content.str();
+
+    Timings timings;
+    size_t pos = 0;
+    const auto expect = [&](char c) {
+        pos = text.find_first_not_of(" \t\r\n", pos);
+        if (pos == std::string::npos || text[pos] != c) {
+            throw std::runtime_error("Malformed baseline "s + path);
+        }
+        ++pos;
+    };
+    const auto peek = [&] {
+        pos = text.find_first_not_of(" \t\r\n", pos);
+        return pos == std::string::npos ? '\0' : text[pos];
+    };
+    expect('{');
+    if (peek() == '}') {
+        return timings;
+    }
+    do {
+        expect('"');
+        const size_t end = text.find('"', pos);
+        if (end == std::string::npos) {
+            throw std::runtime_error("Malformed baseline "s + path);
+        }
+        std::string name = text.substr(pos, end - pos);
+        pos = end + 1;
+        expect(':');
+        size_t length = 0;
+        timings[std::move(name)] = std::stod(text.substr(pos), &length);
+        pos += length;
+    } while (peek() == ',' && (++pos, true));
+    expect('}');
+    return timings;
+}
+
+void WriteBaseline(const std::string& path, const Timings& timings) {
+    std::ofstream out(path);
+    out << "{\n" << std::fixed << std::setprecision(3);
+    for (auto it = timings.begin(); it != timings.end(); ++it) {
+        out << "    \"" << it->first << "\": " << it->second << (std::next(it) != timings.end() ? ",\n" : "\n");
+    }
+    out << "}\n";
+    if (!out) {
+        throw std::runtime_error("Cannot write baseline "s + path);
+    }
+}
+
+// Сравнивает замеры с базовым уровнем; операции, которых нет в базовом файле, только выводятся.
+// Регрессией считается замедление больше чем в threshold раз и больше чем на min_regression_ns
+void CompareTimings(const Options& options, const Timings& timings) {
+    const Timings baseline = options.baseline.empty() || options.update ? Timings{} : ReadBaseline(options.baseline);
+    std::cout << '\n'
+              << std::left << std::setw(36) << "timing" << std::right << std::setw(14) << "ns/op" << std::setw(14)
+              << "baseline" << std::setw(10) << "ratio" << '\n';
+    for (const auto& [name, ns] : timings) {
+        std::cout << std::left << std::setw(36) << name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(14) << ns;
+        const auto it = baseline.find(name);
+        if (it == baseline.end()) {
+            std::cout << std::setw(14) << '-' << '\n';
+            continue;
+        }
+        const double ratio = ns / it->second;
+        std::cout << std::setw(14) << it->second << std::setw(10) << ratio;
+        if (ratio > options.threshold && ns - it->second > options.min_regression_ns) {
+            ++failures;
+            std::cout << "  REGRESSION";
+        }
+        std::cout << '\n';
+    }
+}
+
+Options ParseOptions(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg.starts_with("--baseline="sv)) {
+            options.baseline = arg.substr("--baseline="sv.size());
+        } else if (arg == "--update"sv) {
+            options.update = true;
+        } else if (arg.starts_with("--threshold="sv)) {
+            options.threshold = std::stod(std::string(arg.substr("--threshold="sv.size())));
+        } else if (arg.starts_with("--min-regression-ns="sv)) {
+            options.min_regression_ns = std::stod(std::string(arg.substr("--min-regression-ns="sv.size())));
+        } else if (arg.starts_with("--min-time-ms="sv)) {
+            options.min_time = std::chrono::milliseconds(std::stoll(std::string(arg.substr("--min-time-ms="sv.size()))));
+        } else {
+            throw std::invalid_argument("Unknown argument: "s + std::string(arg));
+        }
+    }
+    if (options.update && options.baseline.empty()) {
+        throw std::invalid_argument("--update requires --baseline"s);
+    }
+    return options;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        const Options options = ParseOptions(argc, argv);
+        CheckAllCounts<NothrowMovable>("nothrow_move"sv);
+        CheckAllCounts<ThrowingMovable>("throwing_move"sv);
+        CheckAllCounts<MoveOnly>("move_only"sv);
+        CheckAllCounts<Relocatable>("relocatable"sv);
+
+        Timings timings;
+        MeasureAll<int>(options, "int"sv, timings);
+        MeasureAll<std::string>(options, "string"sv, timings);
+        CompareTimings(options, timings);
+        if (options.update) {
+            WriteBaseline(options.baseline, timings);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (failures > 0) {
+        std::cout << failures << " check(s) failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,284 @@
+#pragma once
+
+#include "vector.h"
+
+#include <bit>
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// Вектор из блоков, размеры которых растут как степени двойки: блок k содержит
+// FirstSegmentSize << k элементов. При росте добавляется новый блок, а существующие
+// элементы не перемещаются, поэтому указатели и ссылки на них остаются действительными
+// до удаления самих элементов. Стоимость добавления не зависит от числа элементов,
+// и при росте не бывает пиков, вызванных переносом всего буфера
+template <typename T, size_t FirstSegmentSize = 16>
+class SegmentedVector {
+    static_assert(std::has_single_bit(FirstSegmentSize), "FirstSegmentSize must be a power of two");
+
+public:
+    template <bool IsConst>
+    class BasicIterator {
+        using Owner = std::conditional_t<IsConst, const SegmentedVector, SegmentedVector>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<IsConst, const T*, T*>;
+        using reference = std::conditional_t<IsConst, const T&, T&>;
+
+        BasicIterator() = default;
+
+        BasicIterator(Owner* owner, size_t index) noexcept
+            : owner_(owner)
+            , index_(index) {
+        }
+
+        operator BasicIterator<true>() const noexcept
+            requires(!IsConst)
+        {
+            return {owner_, index_};
+        }
+
+        reference operator*() const noexcept {
+            return (*owner_)[index_];
+        }
+
+        pointer operator->() const noexcept {
+            return &(*owner_)[index_];
+        }
+
+        reference operator[](difference_type n) const noexcept {
+            return (*owner_)[index_ + n];
+        }
+
+        BasicIterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        BasicIterator operator++(int) noexcept {
+            auto old = *this;
+            ++index_;
+            return old;
+        }
+
+        BasicIterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        BasicIterator operator--(int) noexcept {
+            auto old = *this;
+            --index_;
+            return old;
+        }
+
+        BasicIterator& operator+=(difference_type n) noexcept {
+            index_ += n;
+            return *this;
+        }
+
+        BasicIterator& operator-=(difference_type n) noexcept {
+            index_ -= n;
+            return *this;
+        }
+
+        friend BasicIterator operator+(BasicIterator it, difference_type n) noexcept {
+            return it += n;
+        }
+
+        friend BasicIterator operator+(difference_type n, BasicIterator it) noexcept {
+            return it += n;
+        }
+
+        friend BasicIterator operator-(BasicIterator it, difference_type n) noexcept {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend auto operator<=>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ <=> rhs.index_;
+        }
+
+    private:
+        Owner* owner_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    using iterator = BasicIterator<false>;
+    using const_iterator = BasicIterator<true>;
+
+    SegmentedVector() = default;
+
+    SegmentedVector(const SegmentedVector& other) {
+        Reserve(other.size_);
+        try {
+            for (const T& value : other) {
+                EmplaceBack(value);
+            }
+        } catch (...) {
+            Clear();
+            throw;
+        }
+    }
+
+    SegmentedVector(SegmentedVector&& other) noexcept
+        : blocks_(std::move(other.blocks_))
+        , size_(std::exchange(other.size_, 0)) {
+    }
+
+    SegmentedVector& operator=(const SegmentedVector& rhs) {
+        if (this != &rhs) {
+            SegmentedVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    SegmentedVector& operator=(SegmentedVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Clear();
+            Swap(rhs);
+        }
+        return *this;
+    }
+
+    ~SegmentedVector() {
+        Clear();
+    }
+
+    void Swap(SegmentedVector& other) noexcept {
+        blocks_.Swap(other.blocks_);
+        std::swap(size_, other.size_);
+    }
+
+    iterator begin() noexcept {
+        return {this, 0};
+    }
+
+    iterator end() noexcept {
+        return {this, size_};
+    }
+
+    const_iterator begin() const noexcept {
+        return {this, 0};
+    }
+
+    const_iterator end() const noexcept {
+        return {this, size_};
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return SegmentBegin(blocks_.Size());
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        const auto [block, offset] = Locate(index);
+        return blocks_[block][offset];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        const auto [block, offset] = Locate(index);
+        return blocks_[block][offset];
+    }
+
+    // Выделяет блоки, пока вместимость не станет не меньше capacity
+    void Reserve(size_t capacity) {
+        while (Capacity() < capacity) {
+            AddBlock();
+        }
+    }
+
+    // Новый блок не затрагивает существующие элементы, поэтому аргументы
+    // могут ссылаться на элементы этого же вектора
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if (size_ == Capacity()) {
+            AddBlock();
+        }
+        const auto [block, offset] = Locate(size_);
+        T* value = new (blocks_[block] + offset) T(std::forward<Args>(args)...);
+        ++size_;
+        return *value;
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    void PopBack() noexcept {
+        assert(size_ > 0);
+        std::destroy_at(&(*this)[size_ - 1]);
+        --size_;
+    }
+
+    // Уничтожает все элементы, сохраняя выделенные блоки
+    void Clear() noexcept {
+        while (size_ > 0) {
+            PopBack();
+        }
+    }
+
+    // Освобождает блоки, в которых не осталось элементов
+    void ShrinkToFit() noexcept {
+        while (blocks_.Size() > 0 && SegmentBegin(blocks_.Size() - 1) >= size_) {
+            blocks_.PopBack();
+        }
+    }
+
+private:
+    Vector<RawMemory<T>> blocks_;
+    size_t size_ = 0;
+
+    static constexpr size_t FIRST_SEGMENT_BITS = std::countr_zero(FirstSegmentSize);
+
+    static constexpr size_t SegmentSize(size_t block) noexcept {
+        return FirstSegmentSize << block;
+    }
+
+    // Индекс первого элемента блока, он же суммарная вместимость предыдущих блоков
+    static constexpr size_t SegmentBegin(size_t block) noexcept {
+        return SegmentSize(block) - FirstSegmentSize;
+    }
+
+    static std::pair<size_t, size_t> Locate(size_t index) noexcept {
+        const size_t biased = index + FirstSegmentSize;
+        const size_t block = std::bit_width(biased) - 1 - FIRST_SEGMENT_BITS;
+        return {block, biased - SegmentSize(block)};
+    }
+
+    void AddBlock() {
+        blocks_.EmplaceBack(SegmentSize(blocks_.Size()));
+    }
+};
@@ -0,0 +1,395 @@
+#pragma once
+
+#include "vector.h"
+
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Вектор записей, хранящий каждое поле в отдельном массиве (struct of arrays).
+// Циклы, читающие одно-два поля, проходят только по нужным столбцам, которые
+// доступны как std::span через Column<I>(). Строка представлена кортежем ссылок
+template <typename... Fields>
+class SoAVector {
+    static_assert(sizeof...(Fields) > 0, "SoAVector requires at least one field");
+
+    template <size_t I>
+    using FieldType = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+    using Indices = std::index_sequence_for<Fields...>;
+
+public:
+    using value_type = std::tuple<Fields...>;
+    using reference = std::tuple<Fields&...>;
+    using const_reference = std::tuple<const Fields&...>;
+
+    // Итератор по строкам. Разыменование возвращает кортеж ссылок по значению,
+    // поэтому итератор является прокси-итератором
+    template <bool IsConst>
+    class BasicIterator {
+        using Owner = std::conditional_t<IsConst, const SoAVector, SoAVector>;
+
+    public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = SoAVector::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<IsConst, SoAVector::const_reference, SoAVector::reference>;
+
+        BasicIterator() = default;
+
+        BasicIterator(Owner* owner, size_t index) noexcept
+            : owner_(owner)
+            , index_(index) {
+        }
+
+        operator BasicIterator<true>() const noexcept
+            requires(!IsConst)
+        {
+            return {owner_, index_};
+        }
+
+        reference operator*() const noexcept {
+            return (*owner_)[index_];
+        }
+
+        reference operator[](difference_type n) const noexcept {
+            return (*owner_)[index_ + n];
+        }
+
+        BasicIterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        BasicIterator operator++(int) noexcept {
+            auto old = *this;
+            ++index_;
+            return old;
+        }
+
+        BasicIterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        BasicIterator operator--(int) noexcept {
+            auto old = *this;
+            --index_;
+            return old;
+        }
+
+        BasicIterator& operator+=(difference_type n) noexcept {
+            index_ += n;
+            return *this;
+        }
+
+        BasicIterator& operator-=(difference_type n) noexcept {
+            index_ -= n;
+            return *this;
+        }
+
+        friend BasicIterator operator+(BasicIterator it, difference_type n) noexcept {
+            return it += n;
+        }
+
+        friend BasicIterator operator+(difference_type n, BasicIterator it) noexcept {
+            return it += n;
+        }
+
+        friend BasicIterator operator-(BasicIterator it, difference_type n) noexcept {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend auto operator<=>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ <=> rhs.index_;
+        }
+
+    private:
+        Owner* owner_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    using iterator = BasicIterator<false>;
+    using const_iterator = BasicIterator<true>;
+
+    SoAVector() = default;
+
+    SoAVector(const SoAVector& other)
+        : columns_(RawMemory<Fields>(other.size_)...) {
+        CopyColumns(other, Indices{});
+        size_ = other.size_;
+    }
+
+    SoAVector(SoAVector&& other) noexcept
+        : columns_(std::move(other.columns_))
+        , size_(std::exchange(other.size_, 0)) {
+    }
+
+    SoAVector& operator=(const SoAVector& rhs) {
+        if (this != &rhs) {
+            SoAVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    SoAVector& operator=(SoAVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Clear();
+            Swap(rhs);
+        }
+        return *this;
+    }
+
+    ~SoAVector() {
+        Clear();
+    }
+
+    void Swap(SoAVector& other) noexcept {
+        SwapColumns(other, Indices{});
+        std::swap(size_, other.size_);
+    }
+
+    iterator begin() noexcept {
+        return {this, 0};
+    }
+
+    iterator end() noexcept {
+        return {this, size_};
+    }
+
+    const_iterator begin() const noexcept {
+        return {this, 0};
+    }
+
+    const_iterator end() const noexcept {
+        return {this, size_};
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return std::get<0>(columns_).Capacity();
+    }
+
+    // Столбец поля с индексом I
+    template <size_t I>
+    std::span<FieldType<I>> Column() noexcept {
+        return {std::get<I>(columns_).GetAddress(), size_};
+    }
+
+    template <size_t I>
+    std::span<const FieldType<I>> Column() const noexcept {
+        return {std::get<I>(columns_).GetAddress(), size_};
+    }
+
+    reference operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Row(index, Indices{});
+    }
+
+    const_reference operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return Row(index, Indices{});
+    }
+
+    // Все столбцы переносятся в новые буферы, которые выделяются заранее. Если перенос
+    // какого-либо столбца выбросит исключение, вектор останется в прежнем состоянии
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= Capacity()) {
+            return;
+        }
+        ChangeCapacity(new_capacity, Indices{});
+    }
+
+    // Добавляет строку, поле I которой создаётся из args[I]
+    template <typename... Args>
+        requires(sizeof...(Args) == sizeof...(Fields))
+    reference EmplaceBack(Args&&... args) {
+        if (size_ == Capacity()) {
+            // Аргументы могут ссылаться на элементы вектора, поэтому строка
+            // создаётся до реаллокации
+            value_type row(std::forward<Args>(args)...);
+            Reserve(DoublingGrowth<>::NextCapacity(size_, (sizeof(Fields) + ...)));
+            std::apply(
+                [this](Fields&... fields) {
+                    ConstructRow(size_, Indices{}, std::move(fields)...);
+                },
+                row);
+        } else {
+            ConstructRow(size_, Indices{}, std::forward<Args>(args)...);
+        }
+        ++size_;
+        return (*this)[size_ - 1];
+    }
+
+    void PushBack(const value_type& row) {
+        std::apply(
+            [this](const Fields&... fields) {
+                EmplaceBack(fields...);
+            },
+            row);
+    }
+
+    void PushBack(value_type&& row) {
+        std::apply(
+            [this](Fields&... fields) {
+                EmplaceBack(std::move(fields)...);
+            },
+            row);
+    }
+
+    void PopBack() noexcept {
+        assert(size_ > 0);
+        --size_;
+        DestroyRow(size_, sizeof...(Fields), Indices{});
+    }
+
+    // Уничтожает все строки, сохраняя вместимость
+    void Clear() noexcept {
+        DestroyColumns(columns_, size_, Indices{});
+        size_ = 0;
+    }
+
+private:
+    using Columns = std::tuple<RawMemory<Fields>...>;
+
+    Columns columns_;
+    size_t size_ = 0;
+
+    template <size_t... I>
+    reference Row(size_t index, std::index_sequence<I...>) noexcept {
+        return reference(std::get<I>(columns_)[index]...);
+    }
+
+    template <size_t... I>
+    const_reference Row(size_t index, std::index_sequence<I...>) const noexcept {
+        return const_reference(std::get<I>(columns_)[index]...);
+    }
+
+    // Создаёт поля строки index, при исключении уничтожая уже созданные
+    template <size_t... I, typename... Args>
+    void ConstructRow(size_t index, std::index_sequence<I...>, Args&&... args) {
+        size_t constructed = 0;
+        try {
+            ((std::construct_at(std::get<I>(columns_) + index, std::forward<Args>(args)), ++constructed), ...);
+        } catch (...) {
+            DestroyRow(index, constructed, Indices{});
+            throw;
+        }
+    }
+
+    // Уничтожает первые count полей строки index
+    template <size_t... I>
+    void DestroyRow(size_t index, size_t count, std::index_sequence<I...>) noexcept {
+        ((I < count ? std::destroy_at(std::get<I>(columns_) + index) : void()), ...);
+    }
+
+    template <size_t... I>
+    static void DestroyColumns(Columns& columns, size_t size, std::index_sequence<I...>) noexcept {
+        (std::destroy_n(std::get<I>(columns).GetAddress(), size), ...);
+    }
+
+    // Уничтожает первые count столбцов, созданных в columns
+    template <size_t... I>
+    static void DestroyColumnsPrefix(Columns& columns, size_t count, size_t size, std::index_sequence<I...>) noexcept {
+        ((I < count ? (void)std::destroy_n(std::get<I>(columns).GetAddress(), size) : void()), ...);
+    }
+
+    template <size_t... I>
+    void SwapColumns(SoAVector& other, std::index_sequence<I...>) noexcept {
+        (std::get<I>(columns_).Swap(std::get<I>(other.columns_)), ...);
+    }
+
+    template <size_t... I>
+    void CopyColumns(const SoAVector& other, std::index_sequence<I...>) {
+        size_t copied = 0;
+        try {
+            ((std::uninitialized_copy_n(std::get<I>(other.columns_).GetAddress(), other.size_,
+                                        std::get<I>(columns_).GetAddress()),
+              ++copied),
+             ...);
+        } catch (...) {
+            DestroyColumnsPrefix(columns_, copied, other.size_, Indices{});
+            throw;
+        }
+    }
+
+    // Переносит столбец так же, как Vector: побайтово, перемещением или копированием
+    template <typename T>
+    static void TransferColumn(RawMemory<T>& from, size_t n, RawMemory<T>& to) {
+        if constexpr (IsTriviallyRelocatableV<T>) {
+            if (n != 0) {
+                std::memcpy(static_cast<void*>(to.GetAddress()), static_cast<const void*>(from.GetAddress()),
+                            n * sizeof(T));
+            }
+        } else if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            std::uninitialized_move_n(from.GetAddress(), n, to.GetAddress());
+        } else {
+            std::uninitialized_copy_n(from.GetAddress(), n, to.GetAddress());
+        }
+    }
+
+    template <typename T>
+    static void DestroyTransferred(RawMemory<T>& column, size_t n) noexcept {
+        if constexpr (!IsTriviallyRelocatableV<T>) {
+            std::destroy_n(column.GetAddress(), n);
+        }
+    }
+
+    // Очерёдность переноса столбца: 0 — копированием, 1 — перемещением, которое может
+    // выбросить исключение, 2 — без исключений
+    template <typename T>
+    static constexpr int TRANSFER_STAGE = IsTriviallyRelocatableV<T> || std::is_nothrow_move_constructible_v<T> ? 2
+                                          : std::is_copy_constructible_v<T>                                     ? 0
+                                                                                                                : 1;
+
+    // Сначала копируются столбцы, которые могут выбросить исключение: исходные столбцы при этом
+    // не меняются, и откат уничтожает только созданные копии. Побайтовые копии при откате
+    // не уничтожаются, ими по-прежнему владеют исходные столбцы. Строгая гарантия не
+    // обеспечивается, только если выбросит перемещение столбца некопируемого типа
+    template <size_t... I>
+    void ChangeCapacity(size_t new_capacity, std::index_sequence<I...>) {
+        Columns new_columns{RawMemory<Fields>(new_capacity)...};
+        bool transferred[sizeof...(Fields)] = {};
+        try {
+            for (int stage = 0; stage <= 2; ++stage) {
+                ((TRANSFER_STAGE<Fields> == stage
+                      ? (TransferColumn(std::get<I>(columns_), size_, std::get<I>(new_columns)), transferred[I] = true)
+                      : false),
+                 ...);
+            }
+        } catch (...) {
+            ((transferred[I] ? DestroyTransferred(std::get<I>(new_columns), size_) : void()), ...);
+            throw;
+        }
+        (DestroyTransferred(std::get<I>(columns_), size_), ...);
+        (std::get<I>(columns_).Swap(std::get<I>(new_columns)), ...);
+    }
+};
@@ -0,0 +1,347 @@
+#pragma once
+
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Хранилище StaticVector. Для тривиальных типов это обычный массив: с ним вектор можно
+// создавать и изменять в constexpr-выражениях, а сам вектор тривиально копируется.
+// Для остальных типов память не инициализируется, элементы создаются в ней по месту
+template <typename T, size_t N, bool = std::is_trivial_v<T>>
+struct StaticStorage {
+    constexpr T* Get() noexcept {
+        return values;
+    }
+
+    constexpr const T* Get() const noexcept {
+        return values;
+    }
+
+    constexpr T* GetLive() noexcept {
+        return values;
+    }
+
+    constexpr const T* GetLive() const noexcept {
+        return values;
+    }
+
+    T values[N == 0 ? 1 : N];
+};
+
+// Get возвращает адрес начала памяти для создания элементов, GetLive — указатель на уже
+// созданный первый элемент. Отмывать указатель можно только там, где объект T существует
+template <typename T, size_t N>
+struct StaticStorage<T, N, false> {
+    T* Get() noexcept {
+        return reinterpret_cast<T*>(bytes);
+    }
+
+    const T* Get() const noexcept {
+        return reinterpret_cast<const T*>(bytes);
+    }
+
+    T* GetLive() noexcept {
+        return std::launder(Get());
+    }
+
+    const T* GetLive() const noexcept {
+        return std::launder(Get());
+    }
+
+    alignas(T) std::byte bytes[(N == 0 ? 1 : N) * sizeof(T)];
+};
+
+// Вектор с вместимостью N, заданной при компиляции. Элементы хранятся внутри объекта,
+// память из кучи не выделяется никогда. Превышение вместимости в EmplaceBack, Insert и Resize
+// приводит к исключению std::length_error; TryEmplaceBack вместо этого возвращает nullptr.
+// Для тривиальных T все операции доступны в constexpr-выражениях
+template <typename T, size_t N>
+class StaticVector {
+    static constexpr bool TRIVIAL = std::is_trivial_v<T>;
+
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    constexpr StaticVector() noexcept {
+        if constexpr (TRIVIAL) {
+            // В constexpr-выражении не должно оставаться неинициализированных элементов
+            if (std::is_constant_evaluated()) {
+                std::fill_n(storage_.values, std::size(storage_.values), T{});
+            }
+        }
+    }
+
+    constexpr explicit StaticVector(size_t size)
+        : StaticVector() {
+        Resize(size);
+    }
+
+    constexpr StaticVector(std::initializer_list<T> values)
+        : StaticVector() {
+        CheckCapacity(values.size());
+        for (const T& value : values) {
+            EmplaceBack(value);
+        }
+    }
+
+    constexpr StaticVector(const StaticVector& other)
+        requires TRIVIAL
+    = default;
+
+    StaticVector(const StaticVector& other) {
+        std::uninitialized_copy_n(other.begin(), other.size_, begin());
+        size_ = other.size_;
+    }
+
+    constexpr StaticVector(StaticVector&& other) noexcept
+        requires TRIVIAL
+    = default;
+
+    StaticVector(StaticVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        std::uninitialized_move_n(other.begin(), other.size_, begin());
+        size_ = other.size_;
+    }
+
+    constexpr StaticVector& operator=(const StaticVector& rhs)
+        requires TRIVIAL
+    = default;
+
+    StaticVector& operator=(const StaticVector& rhs) {
+        if (this != &rhs) {
+            Assign(rhs.begin(), rhs.size_);
+        }
+        return *this;
+    }
+
+    constexpr StaticVector& operator=(StaticVector&& rhs) noexcept
+        requires TRIVIAL
+    = default;
+
+    StaticVector& operator=(StaticVector&& rhs) noexcept(std::is_nothrow_move_assignable_v<T>
+                                                         && std::is_nothrow_move_constructible_v<T>) {
+        if (this != &rhs) {
+            Assign(std::make_move_iterator(rhs.begin()), rhs.size_);
+        }
+        return *this;
+    }
+
+    constexpr ~StaticVector()
+        requires TRIVIAL
+    = default;
+
+    ~StaticVector() {
+        std::destroy_n(begin(), size_);
+    }
+
+    constexpr iterator begin() noexcept {
+        return size_ == 0 ? storage_.Get() : storage_.GetLive();
+    }
+
+    constexpr iterator end() noexcept {
+        return begin() + size_;
+    }
+
+    constexpr const_iterator begin() const noexcept {
+        return size_ == 0 ? storage_.Get() : storage_.GetLive();
+    }
+
+    constexpr const_iterator end() const noexcept {
+        return begin() + size_;
+    }
+
+    constexpr const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    constexpr const_iterator cend() const noexcept {
+        return end();
+    }
+
+    constexpr size_t Size() const noexcept {
+        return size_;
+    }
+
+    static constexpr size_t Capacity() noexcept {
+        return N;
+    }
+
+    constexpr const T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return begin()[index];
+    }
+
+    constexpr T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return begin()[index];
+    }
+
+    // Возвращает nullptr, если вектор заполнен
+    template <typename... Args>
+    constexpr T* TryEmplaceBack(Args&&... args) {
+        if (size_ == N) {
+            return nullptr;
+        }
+        T* result = Construct(end(), std::forward<Args>(args)...);
+        ++size_;
+        return result;
+    }
+
+    template <typename... Args>
+    constexpr T& EmplaceBack(Args&&... args) {
+        CheckCapacity(size_ + 1);
+        return *TryEmplaceBack(std::forward<Args>(args)...);
+    }
+
+    constexpr void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    constexpr void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    constexpr void PopBack() noexcept {
+        assert(size_ > 0);
+        --size_;
+        Destroy(end());
+    }
+
+    template <typename... Args>
+    constexpr iterator Emplace(const_iterator pos, Args&&... args) {
+        CheckCapacity(size_ + 1);
+        const size_t num_pos = pos - cbegin();
+        if (num_pos == size_) {
+            return TryEmplaceBack(std::forward<Args>(args)...);
+        }
+        if constexpr (sizeof...(Args) == 1 && (std::is_same_v<std::remove_cvref_t<Args>, T> && ...)) {
+            // Единственный аргумент типа T присваивается напрямую, без временного объекта.
+            // В constexpr-выражении адреса разных объектов сравнивать нельзя
+            if (!std::is_constant_evaluated()) {
+                AssignShifted(num_pos, std::forward<Args>(args)...);
+                return begin() + num_pos;
+            }
+        }
+        // Значение создаётся до сдвига: аргументы могут ссылаться на элементы вектора
+        T value(std::forward<Args>(args)...);
+        ShiftTailRight(num_pos);
+        begin()[num_pos] = std::move(value);
+        return begin() + num_pos;
+    }
+
+    constexpr iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+
+    constexpr iterator Insert(const_iterator pos, T&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    constexpr iterator Erase(const_iterator pos) {
+        return Erase(pos, pos + 1);
+    }
+
+    constexpr iterator Erase(const_iterator first, const_iterator last) {
+        const size_t num_first = first - cbegin();
+        const size_t count = last - first;
+        if (count == 0) {
+            // Иначе хвост перемещался бы сам в себя
+            return begin() + num_first;
+        }
+        std::move(begin() + num_first + count, end(), begin() + num_first);
+        for (size_t i = 0; i < count; ++i) {
+            PopBack();
+        }
+        return begin() + num_first;
+    }
+
+    constexpr void Resize(size_t new_size) {
+        CheckCapacity(new_size);
+        while (size_ > new_size) {
+            PopBack();
+        }
+        while (size_ < new_size) {
+            TryEmplaceBack();
+        }
+    }
+
+    constexpr void Clear() noexcept {
+        while (size_ > 0) {
+            PopBack();
+        }
+    }
+
+private:
+    StaticStorage<T, N> storage_;
+    size_t size_ = 0;
+
+    static constexpr void CheckCapacity(size_t size) {
+        if (size > N) {
+            throw std::length_error("StaticVector capacity exceeded");
+        }
+    }
+
+    template <typename... Args>
+    static constexpr T* Construct(T* place, Args&&... args) {
+        if constexpr (TRIVIAL) {
+            *place = T(std::forward<Args>(args)...);
+            return place;
+        } else {
+            return new (place) T(std::forward<Args>(args)...);
+        }
+    }
+
+    static constexpr void Destroy(T* place) noexcept {
+        if constexpr (!TRIVIAL) {
+            std::destroy_at(place);
+        }
+    }
+
+    // Переносит последний элемент в свободную ячейку за концом и сдвигает [num_pos, size_ - 1)
+    // на одну позицию вправо перемещением
+    constexpr void ShiftTailRight(size_t num_pos) {
+        Construct(end(), std::move(begin()[size_ - 1]));
+        ++size_;
+        std::move_backward(begin() + num_pos, end() - 2, end() - 1);
+    }
+
+    // Сдвигает хвост и присваивает value в позицию num_pos. Если value — элемент сдвигаемого
+    // хвоста, после сдвига он находится по адресу на единицу больше
+    template <typename Arg>
+    void AssignShifted(size_t num_pos, Arg&& value) {
+        const T* address = std::addressof(value);
+        if (!std::less<const T*>{}(address, begin() + num_pos) && std::less<const T*>{}(address, end())) {
+            ++address;
+        }
+        ShiftTailRight(num_pos);
+        begin()[num_pos] = std::forward<Arg>(const_cast<std::remove_reference_t<Arg>&>(*address));
+    }
+
+    // Присваивает имеющимся элементам, недостающие создаёт, лишние уничтожает
+    template <typename InputIt>
+    void Assign(InputIt first, size_t count) {
+        const size_t common = std::min(count, size_);
+        for (size_t i = 0; i < common; ++i, ++first) {
+            begin()[i] = *first;
+        }
+        while (size_ > count) {
+            PopBack();
+        }
+        for (size_t i = common; i < count; ++i, ++first) {
+            TryEmplaceBack(*first);
+        }
+    }
+};
+
+template <typename T, size_t N>
+struct IsTriviallyRelocatable<StaticVector<T, N>> : IsTriviallyRelocatable<T> {};
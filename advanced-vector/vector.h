@@ -1,40 +1,814 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
+#include <bit>
 #include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <new>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
 #include <utility>
-#include <memory>
+#include <vector>
+
+// Тип тривиально перемещаем, если перенос объекта в другую память через memcpy
+// без вызова деструктора исходного объекта эквивалентен перемещению с разрушением.
+// Для собственных типов можно объявить специализацию
+// template <> struct IsTriviallyRelocatable<MyType> : std::true_type {};
+template <typename T>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<T> {};
+
+template <typename T, typename Deleter>
+struct IsTriviallyRelocatable<std::unique_ptr<T, Deleter>> : IsTriviallyRelocatable<Deleter> {};
+
+template <typename T>
+inline constexpr bool IsTriviallyRelocatableV = IsTriviallyRelocatable<T>::value;
+
+// Политики роста вместимости. NextCapacity возвращает новую вместимость заполненного
+// вектора из size элементов размером element_size байт
+
+// Удвоение вместимости, пустой вектор получает MinCapacity элементов
+template <size_t MinCapacity = 1>
+struct DoublingGrowth {
+    static size_t NextCapacity(size_t size, size_t /*element_size*/) noexcept {
+        return std::max(size * 2, MinCapacity);
+    }
+};
+
+// Рост в 1.5 раза: освобождённые ранее блоки со временем становятся достаточными
+// для повторного использования аллокатором
+template <size_t MinCapacity = 1>
+struct OneAndHalfGrowth {
+    static size_t NextCapacity(size_t size, size_t /*element_size*/) noexcept {
+        return std::max(size + (size + 1) / 2, MinCapacity);
+    }
+};
+
+// Удвоение с округлением размера блока вверх: до степени двойки для небольших блоков
+// (классы размеров malloc) и до целого числа страниц для крупных
+template <size_t MinCapacity = 1, size_t PageSize = 4096>
+struct SizeClassGrowth {
+    static_assert(std::has_single_bit(PageSize), "PageSize must be a power of two");
+
+    static size_t NextCapacity(size_t size, size_t element_size) noexcept {
+        const size_t bytes = std::max(size * 2, MinCapacity) * element_size;
+        const size_t rounded = bytes < PageSize ? std::bit_ceil(bytes) : (bytes + PageSize - 1) & ~(PageSize - 1);
+        return rounded / element_size;
+    }
+};
+
+// Удвоение, но не более чем на MaxIncrementBytes за раз: для очень больших буферов
+template <size_t MaxIncrementBytes, size_t MinCapacity = 1>
+struct CappedIncrementGrowth {
+    static size_t NextCapacity(size_t size, size_t element_size) noexcept {
+        const size_t max_increment = std::max<size_t>(MaxIncrementBytes / element_size, 1);
+        return std::max(size + std::min(std::max<size_t>(size, 1), max_increment), MinCapacity);
+    }
+};
+
+// Политика может дополнительно объявить RoundCapacity(capacity), округляющую вверх любую
+// запрошенную вместимость, в том числе в Reserve, ShrinkTo и конструкторах
+template <typename GrowthPolicy>
+concept RoundingGrowthPolicy = requires(size_t n) {
+    { GrowthPolicy::RoundCapacity(n) } -> std::convertible_to<size_t>;
+};
+
+// Вместимость кратна Multiple элементам: векторные циклы могут обрабатывать хвост
+// полными регистрами без скалярной доводки
+template <size_t Multiple, typename Base = DoublingGrowth<>>
+struct PaddedGrowth {
+    static_assert(Multiple > 0, "Multiple must be positive");
+
+    static size_t RoundCapacity(size_t capacity) noexcept {
+        return (capacity + Multiple - 1) / Multiple * Multiple;
+    }
+
+    static size_t NextCapacity(size_t size, size_t element_size) noexcept {
+        return RoundCapacity(Base::NextCapacity(size, element_size));
+    }
+};
+
+// Подсказка вместимости для одного места заполнения векторов. Объект хранит размеры,
+// которых векторы достигли в последних HISTORY заполнениях, и предлагает максимальный
+// из них: Reserve(hint) заранее выделяет столько, сколько понадобилось недавно, а разовый
+// выброс забывается через HISTORY заполнений. Обычно подсказка — статическая переменная
+// рядом с циклом заполнения:
+//     static CapacityHint hint;
+//     Vector<Request> requests;
+//     auto tracker = hint.Track(requests);  // Reserve сейчас, Record при выходе из области
+// Методы можно вызывать из нескольких потоков одновременно
+class CapacityHint {
+public:
+    static constexpr size_t HISTORY = 8;
+
+    template <typename Container>
+    class [[nodiscard]] Tracker {
+    public:
+        explicit Tracker(CapacityHint& hint, Container& container)
+            : hint_(hint)
+            , container_(container) {
+            container_.Reserve(hint_);
+        }
+
+        Tracker(const Tracker&) = delete;
+        Tracker& operator=(const Tracker&) = delete;
+
+        ~Tracker() {
+            hint_.Record(container_.Size());
+        }
+
+    private:
+        CapacityHint& hint_;
+        Container& container_;
+    };
+
+    // Запоминает размер, которого достиг вектор, вытесняя самый старый
+    void Record(size_t size) noexcept {
+        const size_t slot = next_.fetch_add(1, std::memory_order_relaxed) % HISTORY;
+        sizes_[slot].store(size, std::memory_order_relaxed);
+    }
+
+    // Максимальный из недавних размеров; 0, пока ничего не записано
+    size_t Suggest() const noexcept {
+        size_t result = 0;
+        for (const auto& size : sizes_) {
+            result = std::max(result, size.load(std::memory_order_relaxed));
+        }
+        return result;
+    }
+
+    template <typename Container>
+    Tracker<Container> Track(Container& container) {
+        return Tracker<Container>(*this, container);
+    }
+
+private:
+    std::atomic<size_t> sizes_[HISTORY] = {};
+    std::atomic<size_t> next_ = 0;
+};
+
+// Уровень проверок Vector задаётся макросом VECTOR_CHECK_LEVEL до подключения заголовка:
+// 0 — проверок нет (по умолчанию);
+// 1 — проверяются индексы operator[], позиции Insert, Emplace и Erase и PopBack пустого вектора.
+//     Каждая проверка — одно сравнение, уровень подходит для канареечных сборок;
+// 2 — дополнительно итераторы запоминают поколение буфера и обнаруживают обращение
+//     после реаллокации. Как и в std::vector, при перемещении и обмене векторов итераторы
+//     следуют за буфером и остаются действительными; недействительными они становятся,
+//     только если элементы переносятся поштучно (встроенный буфер SmallVector, неравные
+//     аллокаторы). Итератор нельзя использовать после уничтожения вектора, владеющего буфером.
+// Нарушение передаётся обработчику VectorCheckFailed.
+// Уровень меняет раскладку Vector и тип его итераторов, поэтому Vector объявлен во встроенном
+// пространстве имён vector_check_level_N: единицы трансляции с разными уровнями получают
+// разные искажённые имена вместо молчаливого нарушения ODR
+#ifndef VECTOR_CHECK_LEVEL
+#define VECTOR_CHECK_LEVEL 0
+#endif
+#define VECTOR_CHECK_NAMESPACE_IMPL(level) vector_check_level_##level
+#define VECTOR_CHECK_NAMESPACE(level) VECTOR_CHECK_NAMESPACE_IMPL(level)
+inline constexpr bool VECTOR_BOUNDS_CHECKS = VECTOR_CHECK_LEVEL >= 1;
+inline constexpr bool VECTOR_CHECKED_ITERATORS = VECTOR_CHECK_LEVEL >= 2;
+
+// Обработчик нарушения проверки. Он не должен возвращать управление: проверки стоят
+// в noexcept-функциях. Обработчик по умолчанию выводит сообщение в stderr и вызывает abort
+using VectorCheckHandler = void (*)(const char* message);
+
+inline std::atomic<VectorCheckHandler>& GetVectorCheckHandlerSlot() noexcept {
+    static std::atomic<VectorCheckHandler> handler = nullptr;
+    return handler;
+}
+
+// Устанавливает обработчик и возвращает прежний; nullptr восстанавливает обработчик по умолчанию
+inline VectorCheckHandler SetVectorCheckHandler(VectorCheckHandler handler) noexcept {
+    return GetVectorCheckHandlerSlot().exchange(handler);
+}
+
+[[noreturn]] inline void VectorCheckFailed(const char* message) noexcept {
+    if (const VectorCheckHandler handler = GetVectorCheckHandlerSlot().load()) {
+        handler(message);
+    } else {
+        std::fprintf(stderr, "Vector check failed: %s\n", message);
+    }
+    std::abort();
+}
+
+// Итератор Vector на уровне проверок 2: указатель на элемент, адрес счётчика поколений
+// вектора и поколение буфера на момент создания итератора
+template <typename T>
+class CheckedIterator {
+public:
+    using iterator_concept = std::contiguous_iterator_tag;
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::remove_cv_t<T>;
+    using element_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+    CheckedIterator() = default;
+
+    CheckedIterator(T* ptr, const size_t* generation) noexcept
+        : ptr_(ptr)
+        , owner_generation_(generation)
+        , generation_(generation != nullptr ? *generation : 0) {
+    }
+
+    operator CheckedIterator<const T>() const noexcept
+        requires(!std::is_const_v<T>)
+    {
+        return CheckedIterator<const T>(ptr_, owner_generation_, generation_);
+    }
+
+    // Адрес элемента после проверки поколения
+    T* Get() const noexcept {
+        if (owner_generation_ != nullptr && *owner_generation_ != generation_) [[unlikely]] {
+            VectorCheckFailed("iterator used after the vector buffer was replaced");
+        }
+        return ptr_;
+    }
+
+    reference operator*() const noexcept {
+        return *Get();
+    }
+
+    pointer operator->() const noexcept {
+        return Get();
+    }
+
+    reference operator[](difference_type n) const noexcept {
+        return Get()[n];
+    }
+
+    CheckedIterator& operator++() noexcept {
+        ++ptr_;
+        return *this;
+    }
+
+    CheckedIterator operator++(int) noexcept {
+        auto old = *this;
+        ++ptr_;
+        return old;
+    }
+
+    CheckedIterator& operator--() noexcept {
+        --ptr_;
+        return *this;
+    }
+
+    CheckedIterator operator--(int) noexcept {
+        auto old = *this;
+        --ptr_;
+        return old;
+    }
+
+    CheckedIterator& operator+=(difference_type n) noexcept {
+        ptr_ += n;
+        return *this;
+    }
+
+    CheckedIterator& operator-=(difference_type n) noexcept {
+        ptr_ -= n;
+        return *this;
+    }
+
+    friend CheckedIterator operator+(CheckedIterator it, difference_type n) noexcept {
+        return it += n;
+    }
+
+    friend CheckedIterator operator+(difference_type n, CheckedIterator it) noexcept {
+        return it += n;
+    }
+
+    friend CheckedIterator operator-(CheckedIterator it, difference_type n) noexcept {
+        return it -= n;
+    }
+
+    friend difference_type operator-(const CheckedIterator& lhs, const CheckedIterator& rhs) noexcept {
+        return lhs.ptr_ - rhs.ptr_;
+    }
+
+    friend bool operator==(const CheckedIterator& lhs, const CheckedIterator& rhs) noexcept {
+        return lhs.ptr_ == rhs.ptr_;
+    }
+
+    friend auto operator<=>(const CheckedIterator& lhs, const CheckedIterator& rhs) noexcept {
+        return std::compare_three_way{}(lhs.ptr_, rhs.ptr_);
+    }
+
+private:
+    template <typename U>
+    friend class CheckedIterator;
+
+    CheckedIterator(T* ptr, const size_t* owner_generation, size_t generation) noexcept
+        : ptr_(ptr)
+        , owner_generation_(owner_generation)
+        , generation_(generation) {
+    }
+
+    T* ptr_ = nullptr;
+    const size_t* owner_generation_ = nullptr;
+    size_t generation_ = 0;
+};
+
+// Счётчик поколений буфера; без проверяемых итераторов пуст. Счётчик размещается в куче
+// и при перемещении и обмене векторов передаётся вместе с буфером через Swap, поэтому
+// итераторы продолжают проверяться по владельцу буфера. Если счётчик выделить не удалось,
+// итераторы вектора не проверяются
+template <bool Enabled = VECTOR_CHECKED_ITERATORS>
+class BufferGeneration {
+public:
+    BufferGeneration() noexcept = default;
+
+    // Копия вектора получает собственный буфер и, значит, собственный счётчик
+    BufferGeneration(const BufferGeneration& /*other*/) noexcept {
+    }
+
+    BufferGeneration& operator=(const BufferGeneration&) = delete;
+
+    ~BufferGeneration() {
+        delete value_;
+    }
+
+    void Next() noexcept {
+        if (value_ != nullptr) {
+            ++*value_;
+        }
+    }
+
+    const size_t* Get() const noexcept {
+        return value_;
+    }
+
+    void Swap(BufferGeneration& other) noexcept {
+        std::swap(value_, other.value_);
+    }
+
+private:
+    size_t* value_ = new (std::nothrow) size_t(0);
+};
+
+template <>
+class BufferGeneration<false> {
+public:
+    void Next() noexcept {
+    }
+
+    const size_t* Get() const noexcept {
+        return nullptr;
+    }
+
+    void Swap(BufferGeneration& /*other*/) noexcept {
+    }
+};
+
+// Статистика работы векторов по типам элементов. Собирается только если до подключения
+// заголовка определён макрос VECTOR_ENABLE_STATS, иначе точки сбора пусты и не стоят ничего
+#ifdef VECTOR_ENABLE_STATS
+inline constexpr bool VECTOR_STATS_ENABLED = true;
+#else
+inline constexpr bool VECTOR_STATS_ENABLED = false;
+#endif
+
+struct VectorStatsSnapshot {
+    size_t reallocations = 0;        // переносы элементов в новый буфер
+    size_t bytes_allocated = 0;      // всего выделено байт под буферы
+    size_t relocated_by_memcpy = 0;  // элементы, перенесённые побайтово
+    size_t relocated_by_move = 0;    // элементы, перенесённые перемещением
+    size_t relocated_by_copy = 0;    // элементы, перенесённые копированием
+    size_t peak_capacity = 0;        // наибольшая вместимость одного буфера
+    size_t wasted_capacity = 0;      // неиспользованные ячейки в освобождённых буферах
+};
+
+// Реестр всех типов элементов, для которых собиралась статистика
+class VectorStatsRegistry {
+public:
+    using SnapshotFunction = VectorStatsSnapshot (*)();
+
+    struct Entry {
+        std::string_view type_name;
+        SnapshotFunction snapshot;
+    };
+
+    static void Register(std::string_view type_name, SnapshotFunction snapshot) {
+        std::lock_guard lock(GetMutex());
+        GetEntries().push_back({type_name, snapshot});
+    }
+
+    // Вызывает fn(type_name, snapshot) для каждого зарегистрированного типа
+    template <typename Function>
+    static void ForEach(Function fn) {
+        std::vector<Entry> entries;
+        {
+            std::lock_guard lock(GetMutex());
+            entries = GetEntries();
+        }
+        for (const Entry& entry : entries) {
+            fn(entry.type_name, entry.snapshot());
+        }
+    }
+
+private:
+    static std::mutex& GetMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    static std::vector<Entry>& GetEntries() {
+        static std::vector<Entry> entries;
+        return entries;
+    }
+};
+
+template <typename T>
+class VectorStats {
+public:
+    static VectorStatsSnapshot Snapshot() noexcept {
+        VectorStatsSnapshot snapshot;
+        if constexpr (VECTOR_STATS_ENABLED) {
+            const Counters& counters = GetCounters();
+            snapshot.reallocations = counters.reallocations.load(std::memory_order_relaxed);
+            snapshot.bytes_allocated = counters.bytes_allocated.load(std::memory_order_relaxed);
+            snapshot.relocated_by_memcpy = counters.relocated_by_memcpy.load(std::memory_order_relaxed);
+            snapshot.relocated_by_move = counters.relocated_by_move.load(std::memory_order_relaxed);
+            snapshot.relocated_by_copy = counters.relocated_by_copy.load(std::memory_order_relaxed);
+            snapshot.peak_capacity = counters.peak_capacity.load(std::memory_order_relaxed);
+            snapshot.wasted_capacity = counters.wasted_capacity.load(std::memory_order_relaxed);
+        }
+        return snapshot;
+    }
+
+    static void Reset() noexcept {
+        if constexpr (VECTOR_STATS_ENABLED) {
+            Counters& counters = GetCounters();
+            counters.reallocations.store(0, std::memory_order_relaxed);
+            counters.bytes_allocated.store(0, std::memory_order_relaxed);
+            counters.relocated_by_memcpy.store(0, std::memory_order_relaxed);
+            counters.relocated_by_move.store(0, std::memory_order_relaxed);
+            counters.relocated_by_copy.store(0, std::memory_order_relaxed);
+            counters.peak_capacity.store(0, std::memory_order_relaxed);
+            counters.wasted_capacity.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Выделен буфер вместимостью capacity элементов
+    static void OnAllocate(size_t capacity) noexcept {
+        if constexpr (VECTOR_STATS_ENABLED) {
+            Counters& counters = GetCounters();
+            counters.bytes_allocated.fetch_add(capacity * sizeof(T), std::memory_order_relaxed);
+            size_t peak = counters.peak_capacity.load(std::memory_order_relaxed);
+            while (peak < capacity
+                   && !counters.peak_capacity.compare_exchange_weak(peak, capacity, std::memory_order_relaxed)) {
+            }
+        }
+    }
+
+    // Буфер вместимостью capacity, в котором находилось size элементов, заменён другим
+    static void OnReallocate(size_t capacity, size_t size) noexcept {
+        if constexpr (VECTOR_STATS_ENABLED) {
+            GetCounters().reallocations.fetch_add(1, std::memory_order_relaxed);
+            OnRelease(capacity, size);
+        }
+    }
+
+    // Буфер вместимостью capacity, в котором находилось size элементов, больше не используется
+    static void OnRelease(size_t capacity, size_t size) noexcept {
+        if constexpr (VECTOR_STATS_ENABLED) {
+            GetCounters().wasted_capacity.fetch_add(capacity - size, std::memory_order_relaxed);
+        }
+    }
+
+    static void OnRelocateByMemcpy(size_t count) noexcept {
+        if constexpr (VECTOR_STATS_ENABLED) {
+            GetCounters().relocated_by_memcpy.fetch_add(count, std::memory_order_relaxed);
+        }
+    }
+
+    static void OnRelocateByMove(size_t count) noexcept {
+        if constexpr (VECTOR_STATS_ENABLED) {
+            GetCounters().relocated_by_move.fetch_add(count, std::memory_order_relaxed);
+        }
+    }
+
+    static void OnRelocateByCopy(size_t count) noexcept {
+        if constexpr (VECTOR_STATS_ENABLED) {
+            GetCounters().relocated_by_copy.fetch_add(count, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    struct Counters {
+        Counters() {
+            VectorStatsRegistry::Register(typeid(T).name(), &VectorStats::Snapshot);
+        }
+
+        std::atomic<size_t> reallocations = 0;
+        std::atomic<size_t> bytes_allocated = 0;
+        std::atomic<size_t> relocated_by_memcpy = 0;
+        std::atomic<size_t> relocated_by_move = 0;
+        std::atomic<size_t> relocated_by_copy = 0;
+        std::atomic<size_t> peak_capacity = 0;
+        std::atomic<size_t> wasted_capacity = 0;
+    };
+
+    static Counters& GetCounters() noexcept {
+        static Counters counters;
+        return counters;
+    }
+};
+
+// Аллокатор, умеющий изменять размер ранее выделенного блока (аналог realloc)
+template <typename Allocator>
+concept ReallocatingAllocator = requires(Allocator& alloc, typename std::allocator_traits<Allocator>::pointer p,
+                                         size_t n) {
+    { alloc.reallocate(p, n, n) } -> std::same_as<decltype(p)>;
+};
+
+// Аллокатор поверх malloc/realloc/free. Позволяет вектору тривиально перемещаемых
+// элементов расти без выделения нового буфера: realloc по возможности расширяет
+// блок на месте, а glibc для крупных блоков, полученных через mmap, использует mremap
+template <typename T>
+class MallocAllocator {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "malloc does not support over-aligned types");
+
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    MallocAllocator() = default;
+
+    template <typename U>
+    MallocAllocator(const MallocAllocator<U>& /*other*/) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(CheckAllocated(std::malloc(BytesFor(n))));
+    }
+
+    void deallocate(T* p, size_t /*n*/) noexcept {
+        std::free(p);
+    }
+
+    T* reallocate(T* p, size_t /*old_n*/, size_t new_n) {
+        return static_cast<T*>(CheckAllocated(std::realloc(p, BytesFor(new_n))));
+    }
+
+    friend bool operator==(const MallocAllocator& /*lhs*/, const MallocAllocator& /*rhs*/) noexcept {
+        return true;
+    }
+
+private:
+    static size_t BytesFor(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return n * sizeof(T);
+    }
+
+    static void* CheckAllocated(void* p) {
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+};
+
+// Аллокатор, выравнивающий буфер по Alignment байт через выровненный operator new.
+// Выравнивание по ширине векторного регистра (64 байта для AVX-512) позволяет
+// использовать выровненные загрузки и не пересекать границы кэш-линий
+template <typename T, size_t Alignment>
+class AlignedAllocator {
+    static_assert(std::has_single_bit(Alignment), "Alignment must be a power of two");
+    static_assert(Alignment >= alignof(T), "Alignment must not be weaker than alignof(T)");
+
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>& /*other*/) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{Alignment}));
+    }
+
+    void deallocate(T* p, size_t /*n*/) noexcept {
+        ::operator delete(p, std::align_val_t{Alignment});
+    }
+
+    friend bool operator==(const AlignedAllocator& /*lhs*/, const AlignedAllocator& /*rhs*/) noexcept {
+        return true;
+    }
+};
+
+// Освобождает внешний буфер: вызывается с адресом буфера и его вместимостью после уничтожения
+// элементов. Не должен выбрасывать исключений
+template <typename T>
+using BufferDeleter = std::function<void(T*, size_t)>;
+
+// Аллокатор векторов, принимающих во владение внешние буферы, например из сетевого стека
+// или библиотеки распаковки. Память под рост выделяет Base, а буфер, переданный конструктору
+// вместе с deleter, освобождается этим deleter. Состояние хранится только в этом аллокаторе,
+// векторы с другими аллокаторами за возможность принимать буферы не платят
+template <typename T, typename Base = std::allocator<T>>
+class AdoptingAllocator {
+    using BaseTraits = std::allocator_traits<Base>;
+
+public:
+    using value_type = T;
+    // Аллокатор переходит к другому вектору вместе с буфером, который умеет освободить
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    template <typename U>
+    struct rebind {
+        using other = AdoptingAllocator<U, typename BaseTraits::template rebind_alloc<U>>;
+    };
+
+    AdoptingAllocator() = default;
+
+    explicit AdoptingAllocator(const Base& base) noexcept
+        : base_(base) {
+    }
+
+    AdoptingAllocator(T* buffer, BufferDeleter<T> deleter, const Base& base = Base())
+        : base_(base)
+        , adopted_(std::make_shared<Adopted>(Adopted{buffer, std::move(deleter)})) {
+    }
+
+    template <typename U, typename OtherBase>
+    AdoptingAllocator(const AdoptingAllocator<U, OtherBase>& other) noexcept
+        : base_(other.GetBase()) {
+    }
+
+    // Копия вектора принятый буфер не разделяет
+    AdoptingAllocator select_on_container_copy_construction() const {
+        return AdoptingAllocator(BaseTraits::select_on_container_copy_construction(base_));
+    }
+
+    T* allocate(size_t n) {
+        return BaseTraits::allocate(base_, n);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (adopted_ != nullptr && adopted_->buffer == p) {
+            BufferDeleter<T> deleter = std::move(adopted_->deleter);
+            adopted_->buffer = nullptr;
+            deleter(p, n);
+            return;
+        }
+        BaseTraits::deallocate(base_, p, n);
+    }
+
+    const Base& GetBase() const noexcept {
+        return base_;
+    }
+
+    // Каждый экземпляр может освободить только принятый им самим буфер
+    friend bool operator==(const AdoptingAllocator& lhs, const AdoptingAllocator& rhs) noexcept {
+        return lhs.base_ == rhs.base_ && lhs.adopted_ == rhs.adopted_;
+    }
+
+private:
+    struct Adopted {
+        T* buffer;
+        BufferDeleter<T> deleter;
+    };
+
+    [[no_unique_address]] Base base_;
+    // Разделяется копиями аллокатора, которые вектор делает при реаллокации
+    std::shared_ptr<Adopted> adopted_;
+};
+
+// Встроенный буфер на N элементов для RawMemory с оптимизацией малого размера
+template <typename T, size_t N>
+struct InlineBuffer {
+    // Память намеренно не инициализируется
+    InlineBuffer() noexcept {
+    }
+
+    T* Get() noexcept {
+        return reinterpret_cast<T*>(bytes);
+    }
+
+    const T* Get() const noexcept {
+        return reinterpret_cast<const T*>(bytes);
+    }
+
+    alignas(T) std::byte bytes[N * sizeof(T)];
+};
+
+template <typename T>
+struct InlineBuffer<T, 0> {
+    T* Get() const noexcept {
+        return nullptr;
+    }
+};
 
+// Буфер, отданный вектором через Release. Вызывающая сторона уничтожает size элементов
+// и освобождает память копией аллокатора вектора: alloc.deallocate(data, capacity)
 template <typename T>
+struct ReleasedBuffer {
+    T* data = nullptr;
+    size_t size = 0;
+    size_t capacity = 0;
+};
+
+// Сырая память под элементы. При InlineCapacity > 0 первые InlineCapacity элементов
+// размещаются во встроенном буфере, и аллокатор вызывается только при большей вместимости.
+// Перемещение и обмен передают только владение памятью: содержимое встроенного буфера
+// не переносится, его элементы переносит владелец
+template <typename T, typename Allocator = std::allocator<T>, size_t InlineCapacity = 0>
 class RawMemory {
+    using AllocTraits = std::allocator_traits<Allocator>;
+    static_assert(std::is_same_v<typename AllocTraits::value_type, T>, "Allocator::value_type must be T");
+
 public:
-    RawMemory() = default;
+    using allocator_type = Allocator;
+
+    RawMemory() noexcept(noexcept(Allocator()))
+        : buffer_(inline_.Get())
+        , capacity_(InlineCapacity) {
+    }
+
+    explicit RawMemory(const Allocator& alloc) noexcept
+        : alloc_(alloc)
+        , buffer_(inline_.Get())
+        , capacity_(InlineCapacity) {
+    }
+
+    explicit RawMemory(size_t capacity, const Allocator& alloc = Allocator())
+        : alloc_(alloc)
+        , buffer_(capacity <= InlineCapacity ? inline_.Get() : Allocate(capacity))
+        , capacity_(std::max(capacity, InlineCapacity)) {
+    }
 
-    explicit RawMemory(size_t capacity)
-        : buffer_(Allocate(capacity))
-        , capacity_(capacity) {
+    // Принимает во владение буфер, который alloc умеет освободить
+    RawMemory(T* buffer, size_t capacity, const Allocator& alloc) noexcept
+        : RawMemory(alloc) {
+        if (buffer != nullptr) {
+            buffer_ = buffer;
+            capacity_ = capacity;
+        }
     }
 
     RawMemory(const RawMemory&) = delete;
     RawMemory& operator=(const RawMemory& rhs) = delete;
-    RawMemory(RawMemory&& other) noexcept : buffer_(std::move(other.buffer_)), capacity_(std::move(other.capacity_)) {
-        other.buffer_ = nullptr;
-        other.capacity_ = 0;
+    RawMemory(RawMemory&& other) noexcept
+        : alloc_(std::move(other.alloc_))
+        , buffer_(inline_.Get())
+        , capacity_(InlineCapacity) {
+        if (!other.IsInline()) {
+            buffer_ = std::exchange(other.buffer_, other.inline_.Get());
+            capacity_ = std::exchange(other.capacity_, InlineCapacity);
+        }
     }
+    // Аллокатор забирается у rhs только при propagate_on_container_move_assignment,
+    // иначе вызывающая сторона обязана убедиться, что аллокаторы равны
     RawMemory& operator=(RawMemory&& rhs) noexcept {
         if (this != &rhs) {
-            buffer_ = std::move(rhs.buffer_);
-            capacity_ = std::move(rhs.capacity_);
-            rhs.buffer_ = nullptr;
-            rhs.capacity_ = 0;
+            FreeBuffer();
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                alloc_ = std::move(rhs.alloc_);
+            }
+            buffer_ = inline_.Get();
+            capacity_ = InlineCapacity;
+            if (!rhs.IsInline()) {
+                buffer_ = std::exchange(rhs.buffer_, rhs.inline_.Get());
+                capacity_ = std::exchange(rhs.capacity_, InlineCapacity);
+            }
         }
         return *this;
     }
 
     ~RawMemory() {
-        Deallocate(buffer_);
+        FreeBuffer();
     }
 
     T* operator+(size_t offset) noexcept {
@@ -56,9 +830,73 @@ public:
         return buffer_[index];
     }
 
+    // Аллокаторы обмениваются только при propagate_on_container_swap,
+    // иначе обмен памятью допустим лишь между равными аллокаторами
     void Swap(RawMemory& other) noexcept {
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            std::swap(alloc_, other.alloc_);
+        } else {
+            assert(alloc_ == other.alloc_);
+        }
+        const bool this_inline = IsInline();
+        const bool other_inline = other.IsInline();
         std::swap(buffer_, other.buffer_);
         std::swap(capacity_, other.capacity_);
+        if (other_inline) {
+            buffer_ = inline_.Get();
+        }
+        if (this_inline) {
+            other.buffer_ = other.inline_.Get();
+        }
+    }
+
+    // Изменяет вместимость буфера средствами аллокатора: блок по возможности расширяется
+    // на месте, иначе аллокатор сам переносит его побайтово. Поэтому применимо
+    // только к тривиально перемещаемым типам
+    void Reallocate(size_t new_capacity) requires ReallocatingAllocator<Allocator> {
+        static_assert(IsTriviallyRelocatableV<T>);
+        if (new_capacity <= InlineCapacity) {
+            if (!IsInline()) {
+                if (new_capacity != 0) {
+                    std::memcpy(static_cast<void*>(inline_.Get()), static_cast<const void*>(buffer_),
+                                new_capacity * sizeof(T));
+                }
+                FreeBuffer();
+                buffer_ = inline_.Get();
+            }
+            capacity_ = InlineCapacity;
+            return;
+        }
+        if (IsInline()) {
+            T* new_buffer = Allocate(new_capacity);
+            std::memcpy(static_cast<void*>(new_buffer), static_cast<const void*>(buffer_), capacity_ * sizeof(T));
+            buffer_ = new_buffer;
+        } else if (buffer_ == nullptr) {
+            buffer_ = Allocate(new_capacity);
+        } else {
+            buffer_ = alloc_.reallocate(buffer_, capacity_, new_capacity);
+            VectorStats<T>::OnAllocate(new_capacity);
+        }
+        capacity_ = new_capacity;
+    }
+
+    // Освобождает память и заменяет аллокатор (используется при propagate_on_container_copy_assignment)
+    void Reset(const Allocator& alloc) noexcept {
+        FreeBuffer();
+        buffer_ = inline_.Get();
+        capacity_ = InlineCapacity;
+        alloc_ = alloc;
+    }
+
+    // Отдаёт буфер из кучи и становится пустым. Встроенный буфер отдать нельзя
+    ReleasedBuffer<T> Release() noexcept {
+        assert(!IsInline());
+        ReleasedBuffer<T> result;
+        result.data = buffer_;
+        result.capacity = capacity_;
+        buffer_ = inline_.Get();
+        capacity_ = InlineCapacity;
+        return result;
     }
 
     const T* GetAddress() const noexcept {
@@ -73,42 +911,152 @@ public:
         return capacity_;
     }
 
+    // Размещены ли элементы во встроенном буфере
+    bool IsInline() const noexcept {
+        return InlineCapacity > 0 && buffer_ == inline_.Get();
+    }
+
+    const Allocator& GetAllocator() const noexcept {
+        return alloc_;
+    }
+
 private:
     // Выделяет сырую память под n элементов и возвращает указатель на неё
-    static T* Allocate(size_t n) {
-        return n != 0 ? static_cast<T*>(operator new(n * sizeof(T))) : nullptr;
+    T* Allocate(size_t n) {
+        if (n == 0) {
+            return nullptr;
+        }
+        T* buffer = AllocTraits::allocate(alloc_, n);
+        VectorStats<T>::OnAllocate(n);
+        return buffer;
     }
 
-    // Освобождает сырую память, выделенную ранее по адресу buf при помощи Allocate
-    static void Deallocate(T* buf) noexcept {
-        operator delete(buf);
+    // Возвращает аллокатору текущий буфер, если он был выделен при помощи Allocate
+    void FreeBuffer() noexcept {
+        if (buffer_ != nullptr && !IsInline()) {
+            AllocTraits::deallocate(alloc_, buffer_, capacity_);
+        }
     }
 
-    T* buffer_ = nullptr;
-    size_t capacity_ = 0;
+    [[no_unique_address]] Allocator alloc_;
+    [[no_unique_address]] InlineBuffer<T, InlineCapacity> inline_;
+    T* buffer_;
+    size_t capacity_;
 };
 
-template <typename T>
+// Тег, выбирающий инициализацию элементов по умолчанию вместо обнуляющей
+struct DefaultInit {
+    explicit DefaultInit() = default;
+};
+
+inline constexpr DefaultInit default_init{};
+
+// Тег конструктора, принимающего во владение готовый буфер с элементами
+struct AdoptBuffer {
+    explicit AdoptBuffer() = default;
+};
+
+inline constexpr AdoptBuffer adopt_buffer{};
+
+// Политики выполнения для массовых операций над большими векторами. Своих тегов
+// достаточно, чтобы не зависеть от <execution>, который в libstdc++ требует TBB
+namespace execution {
+
+struct SequencedPolicy {};
+
+struct ParallelPolicy {
+    size_t threads = 0;          // 0 — по числу аппаратных потоков
+    size_t min_chunk = 1 << 14;  // участки меньшего размера не выделяются в отдельный поток
+};
+
+inline constexpr SequencedPolicy seq{};
+inline constexpr ParallelPolicy par{};
+
+}  // namespace execution
+
+template <typename Policy>
+concept ExecutionPolicy = std::same_as<std::remove_cvref_t<Policy>, execution::SequencedPolicy>
+                          || std::same_as<std::remove_cvref_t<Policy>, execution::ParallelPolicy>;
+
+// Делит [0, n) на участки и вызывает fn(first, count) для каждого, при параллельной политике —
+// в отдельных потоках. fn при исключении сама отменяет свою часть работы. Если какой-либо
+// участок завершился исключением, для остальных успешных вызывается rollback(first, count)
+// и пробрасывается первое исключение
+template <ExecutionPolicy Policy, typename Function, typename Rollback>
+void ForEachChunk(const Policy& policy, size_t n, Function&& fn, Rollback&& rollback) {
+    size_t chunks = 1;
+    if constexpr (std::same_as<Policy, execution::ParallelPolicy>) {
+        const size_t threads = policy.threads != 0 ? policy.threads : std::max(std::thread::hardware_concurrency(), 1u);
+        chunks = std::min(threads, n / std::max<size_t>(policy.min_chunk, 1));
+    }
+    if (chunks <= 1) {
+        fn(size_t{0}, n);
+        return;
+    }
+    const size_t chunk_size = (n + chunks - 1) / chunks;
+    chunks = (n + chunk_size - 1) / chunk_size;
+    std::vector<std::exception_ptr> errors(chunks);
+    auto run = [&](size_t chunk) {
+        try {
+            fn(chunk * chunk_size, std::min(chunk_size, n - chunk * chunk_size));
+        } catch (...) {
+            errors[chunk] = std::current_exception();
+        }
+    };
+    {
+        std::vector<std::jthread> workers;
+        workers.reserve(chunks - 1);
+        for (size_t chunk = 1; chunk < chunks; ++chunk) {
+            try {
+                workers.emplace_back(run, chunk);
+            } catch (...) {
+                // Поток не удалось создать, участок выполняется в текущем
+                run(chunk);
+            }
+        }
+        run(0);
+    }
+    const auto failed = std::find_if(errors.begin(), errors.end(), [](const std::exception_ptr& error) {
+        return error != nullptr;
+    });
+    if (failed == errors.end()) {
+        return;
+    }
+    for (size_t chunk = 0; chunk < chunks; ++chunk) {
+        if (errors[chunk] == nullptr) {
+            rollback(chunk * chunk_size, std::min(chunk_size, n - chunk * chunk_size));
+        }
+    }
+    std::rethrow_exception(*failed);
+}
+
+inline namespace VECTOR_CHECK_NAMESPACE(VECTOR_CHECK_LEVEL) {
+
+template <typename T, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth<>,
+          size_t InlineCapacity = 0>
 class Vector {
+    using AllocTraits = std::allocator_traits<Allocator>;
+
 public:
+    using allocator_type = Allocator;
 
-    using iterator = T*;
-    using const_iterator = const T*;
+    using iterator = std::conditional_t<VECTOR_CHECKED_ITERATORS, CheckedIterator<T>, T*>;
+    using const_iterator = std::conditional_t<VECTOR_CHECKED_ITERATORS, CheckedIterator<const T>, const T*>;
 
     iterator begin() noexcept {
-        return data_ + 0;
+        return MakeIterator(data_ + 0);
     }
 
     iterator end() noexcept {
-        return (data_ + size_);
+        return MakeIterator(data_ + size_);
     }
 
     const_iterator begin() const noexcept {
-        return data_ + 0;
+        return MakeIterator(data_ + 0);
     }
 
     const_iterator end() const noexcept {
-        return (data_ + size_);
+        return MakeIterator(data_ + size_);
     }
 
     const_iterator cbegin() const noexcept {
@@ -129,11 +1077,30 @@ public:
     }
     
     iterator Erase(const_iterator pos) noexcept /*noexcept(std::is_nothrow_move_assignable_v<T>)*/ {
-        size_t num_pos = std::distance(cbegin(), pos);
-        std::move(data_ + num_pos + 1, end(), data_ + num_pos);
-        (end() - 1)->~T();
-        --size_;
-        return &data_[num_pos];
+        return Erase(pos, pos + 1);
+    }
+
+    // Удаляет элементы [first, last): хвост сдвигается один раз, и уничтожаются
+    // только освободившиеся в конце элементы
+    iterator Erase(const_iterator first, const_iterator last) noexcept {
+        const size_t num_first = ToIndex(first);
+        const size_t num_last = ToIndex(last);
+        Check(num_first <= num_last, "Erase range is reversed");
+        if (first == last) {
+            // Иначе хвост перемещался бы сам в себя
+            return begin() + num_first;
+        }
+        const size_t count = num_last - num_first;
+        if constexpr (IsTriviallyRelocatableV<T>) {
+            std::destroy_n(data_ + num_first, count);
+            std::memmove(static_cast<void*>(data_ + num_first), static_cast<const void*>(data_ + num_last),
+                         (size_ - num_last) * sizeof(T));
+        } else {
+            std::move(data_ + num_last, data_ + size_, data_ + num_first);
+            std::destroy_n(data_ + (size_ - count), count);
+        }
+        size_ -= count;
+        return begin() + num_first;
     }
 
     iterator Insert(const_iterator pos, const T& value) {
@@ -144,41 +1111,218 @@ public:
         return Emplace(std::forward<const_iterator>(pos), std::forward<T&&>(value));
     }
 
+    // Вставляет count копий value. Вместимость увеличивается не более одного раза,
+    // а элементы после pos сдвигаются однократно
+    iterator Insert(const_iterator pos, size_t count, const T& value) {
+        const size_t num_pos = ToIndex(pos);
+        // value может ссылаться на элемент вектора, который будет сдвинут
+        if (std::less_equal<const T*>()(data_ + 0, &value) && std::less<const T*>()(&value, data_ + size_)) {
+            const T value_copy(value);
+            return InsertN(num_pos, count, [&value_copy](T* dst, size_t n) {
+                std::uninitialized_fill_n(dst, n, value_copy);
+            });
+        }
+        return InsertN(num_pos, count, [&value](T* dst, size_t n) {
+            std::uninitialized_fill_n(dst, n, value);
+        });
+    }
+
+    // Вставляет элементы диапазона [first, last), который не должен принадлежать
+    // этому вектору. Для однопроходных итераторов элементы добавляются в конец
+    // по одному и затем переставляются на место; при исключении добавленные элементы удаляются
+    template <std::input_iterator InputIt>
+    iterator Insert(const_iterator pos, InputIt first, InputIt last) {
+        const size_t num_pos = ToIndex(pos);
+        if constexpr (std::forward_iterator<InputIt>) {
+            return InsertN(num_pos, std::distance(first, last), [&first](T* dst, size_t n) {
+                std::uninitialized_copy_n(first, n, dst);
+            });
+        } else {
+            const size_t old_size = size_;
+            try {
+                for (; first != last; ++first) {
+                    EmplaceBack(*first);
+                }
+                std::rotate(data_ + num_pos, data_ + old_size, data_ + size_);
+            } catch (...) {
+                Erase(begin() + old_size, end());
+                throw;
+            }
+            return begin() + num_pos;
+        }
+    }
+
+    iterator Insert(const_iterator pos, std::initializer_list<T> values) {
+        return Insert(pos, values.begin(), values.end());
+    }
+
+    // Добавляет в конец элементы диапазона, не принадлежащего этому вектору. Итераторы
+    // диапазона могут не быть итераторами C++17, а конец может иметь отдельный тип
+    template <std::ranges::input_range Range>
+    void Append(Range&& range) {
+        if constexpr (std::ranges::forward_range<Range>) {
+            auto first = std::ranges::begin(range);
+            InsertN(size_, static_cast<size_t>(std::ranges::distance(range)), [&first](T* dst, size_t n) {
+                const auto count = static_cast<std::iter_difference_t<decltype(first)>>(n);
+                std::ranges::uninitialized_copy_n(first, count, dst, dst + n);
+            });
+        } else {
+            const size_t old_size = size_;
+            try {
+                for (auto&& value : range) {
+                    EmplaceBack(std::forward<decltype(value)>(value));
+                }
+            } catch (...) {
+                Erase(begin() + old_size, end());
+                throw;
+            }
+        }
+    }
+
     Vector() = default;
 
-    explicit Vector(size_t size)
-        : data_(size)
+    explicit Vector(const Allocator& alloc) noexcept
+        : data_(alloc) {
+    }
+
+    explicit Vector(size_t size, const Allocator& alloc = Allocator())
+        : data_(RoundCapacity(size), alloc)
         , size_(size)  //
     {
         std::uninitialized_value_construct_n(data_.GetAddress(), size);
     }
 
-    Vector(Vector&& other) noexcept : data_(std::move(other.data_)), size_(std::move(other.size_)) {
-        other.size_ = 0;
+    Vector(size_t size, DefaultInit /*tag*/, const Allocator& alloc = Allocator())
+        : data_(RoundCapacity(size), alloc)
+        , size_(size)  //
+    {
+        std::uninitialized_default_construct_n(data_.GetAddress(), size);
+    }
+
+    template <std::input_iterator InputIt>
+    Vector(InputIt first, InputIt last, const Allocator& alloc = Allocator())
+        : data_(alloc) {
+        try {
+            Insert(cend(), first, last);
+        } catch (...) {
+            std::destroy_n(data_.GetAddress(), size_);
+            throw;
+        }
+    }
+
+    Vector(std::initializer_list<T> values, const Allocator& alloc = Allocator())
+        : Vector(values.begin(), values.end(), alloc) {
+    }
+
+    // Принимает во владение без копирования буфер data вместимостью capacity, в котором созданы
+    // size элементов. Буфер освобождается через alloc.deallocate(data, capacity), поэтому он
+    // должен быть выделен alloc (например, получен из Release другого вектора) или передан
+    // конструктору AdoptingAllocator вместе со своим deleter. Первая реаллокация переносит
+    // элементы в память аллокатора и сразу освобождает принятый буфер
+    Vector(AdoptBuffer /*tag*/, T* data, size_t size, size_t capacity, const Allocator& alloc = Allocator())
+        : data_(data, capacity, alloc)
+        , size_(size) {
+        Check(size <= capacity && (data != nullptr || size == 0), "adopted buffer is smaller than its size");
+    }
+
+    Vector(Vector&& other) noexcept(InlineCapacity == 0 || NOTHROW_TRANSFER)
+        : data_(std::move(other.data_)) {
+        if constexpr (InlineCapacity > 0) {
+            // Встроенный буфер нельзя забрать, его элементы переносятся по одному
+            if (data_.IsInline()) {
+                UninitializedTransferN(other.data_.GetAddress(), other.size_, data_.GetAddress());
+                DestroyTransferred(other.data_.GetAddress(), other.size_);
+                size_ = std::exchange(other.size_, 0);
+                other.generation_.Next();
+                return;
+            }
+        }
+        size_ = std::exchange(other.size_, 0);
+        // Итераторы other следуют за его буфером
+        generation_.Swap(other.generation_);
     }
 
     Vector(const Vector& other)
-        : data_(other.size_)
+        : Vector(other, AllocTraits::select_on_container_copy_construction(other.GetAllocator())) {
+    }
+
+    Vector(const Vector& other, const Allocator& alloc)
+        : data_(RoundCapacity(other.size_), alloc)
         , size_(other.size_)  //
     {
-        std::uninitialized_copy_n(other.data_.GetAddress(), size_, data_.GetAddress());
+        UninitializedCopyN(other.data_.GetAddress(), size_, data_.GetAddress());
+    }
+
+    // Перегрузки с политикой выполнения делят диапазон на участки и обрабатывают их
+    // в нескольких потоках. При исключении созданные участки уничтожаются, и вектор
+    // остаётся в прежнем состоянии
+
+    template <ExecutionPolicy Policy>
+    Vector(const Policy& policy, size_t size, const Allocator& alloc = Allocator())
+        : data_(RoundCapacity(size), alloc) {
+        ConstructChunks(policy, data_.GetAddress(), size, [](T* dst, size_t n) {
+            std::uninitialized_value_construct_n(dst, n);
+        });
+        size_ = size;
+    }
+
+    template <ExecutionPolicy Policy>
+    Vector(const Policy& policy, const Vector& other)
+        : Vector(policy, other, AllocTraits::select_on_container_copy_construction(other.GetAllocator())) {
+    }
+
+    template <ExecutionPolicy Policy>
+    Vector(const Policy& policy, const Vector& other, const Allocator& alloc)
+        : data_(RoundCapacity(other.size_), alloc) {
+        const T* from = other.data_.GetAddress();
+        T* to = data_.GetAddress();
+        ForEachChunk(
+            policy, other.size_,
+            [from, to](size_t first, size_t count) {
+                UninitializedCopyN(from + first, count, to + first);
+            },
+            [to](size_t first, size_t count) {
+                std::destroy_n(to + first, count);
+            });
+        size_ = other.size_;
     }
 
     void Resize(size_t new_size) {
-        if (size_ == new_size)
-        {
-            return;
-        } else if (size_ > new_size) {
-            for (size_t i = new_size; i < size_; i++)
-            {
-                std::destroy_at(&data_[i]);
-            }
-            size_ = new_size;
-        } else {
-            Reserve(new_size);
-            std::uninitialized_value_construct_n(&data_[size_], (new_size - size_));
-            size_ = new_size;
+        ResizeWith(new_size, [](T* dst, size_t n) {
+            std::uninitialized_value_construct_n(dst, n);
+        });
+    }
+
+    template <ExecutionPolicy Policy>
+    void Resize(const Policy& policy, size_t new_size) {
+        if (size_ > new_size) {
+            DestroyChunks(policy, data_ + new_size, size_ - new_size);
+        } else if (size_ < new_size) {
+            Reserve(policy, new_size);
+            ConstructChunks(policy, data_ + size_, new_size - size_, [](T* dst, size_t n) {
+                std::uninitialized_value_construct_n(dst, n);
+            });
         }
+        size_ = new_size;
+    }
+
+    // Как Resize, но новые элементы инициализируются по умолчанию:
+    // память под тривиальные типы не обнуляется
+    void ResizeDefaultInit(size_t new_size) {
+        ResizeWith(new_size, [](T* dst, size_t n) {
+            std::uninitialized_default_construct_n(dst, n);
+        });
+    }
+
+    // Аналог std::string::resize_and_overwrite: делает размер равным count, вызывает
+    // op(data, count), которая заполняет буфер и возвращает итоговый размер (не больше count).
+    // Элементы сверх прежнего размера инициализируются по умолчанию
+    template <typename Operation>
+    void ResizeAndOverwrite(size_t count, Operation op) {
+        ResizeDefaultInit(count);
+        const size_t new_size = std::move(op)(data_.GetAddress(), count);
+        assert(new_size <= count);
+        Resize(new_size);
     }
 
     void PushBack(const T& value) {
@@ -196,6 +1340,7 @@ public:
     }
 
     void PopBack() noexcept {
+        Check(size_ > 0, "PopBack on an empty vector");
         std::destroy_at(&data_[size_ - 1]);
         --size_;
     }
@@ -204,18 +1349,72 @@ public:
         if (new_capacity <= data_.Capacity()) {
             return;
         }
-        RawMemory<T> new_data(new_capacity);
-        // constexpr оператор if будет вычислен во время компиляции
-        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-            std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
+        ChangeCapacity(RoundCapacity(new_capacity));
+    }
+
+    // Резервирует вместимость по подсказке; она округляется политикой роста, как в Reserve(n)
+    void Reserve(const CapacityHint& hint) {
+        Reserve(hint.Suggest());
+    }
+
+    // Переносит элементы в новый буфер в нескольких потоках. Буфер, который можно
+    // расширить через reallocate или вернуть во встроенный, переносится как в Reserve
+    template <ExecutionPolicy Policy>
+    void Reserve(const Policy& policy, size_t new_capacity) {
+        if (new_capacity <= data_.Capacity()) {
+            return;
+        }
+        new_capacity = RoundCapacity(new_capacity);
+        if constexpr (CAN_REALLOCATE) {
+            ChangeCapacity(new_capacity);
         } else {
-            std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
+            VectorStats<T>::OnReallocate(data_.Capacity(), size_);
+            RawMemory<T, Allocator, InlineCapacity> new_data(new_capacity, data_.GetAllocator());
+            T* from = data_.GetAddress();
+            T* to = new_data.GetAddress();
+            ForEachChunk(
+                policy, size_,
+                [from, to](size_t first, size_t count) {
+                    UninitializedTransferN(from + first, count, to + first);
+                },
+                [to](size_t first, size_t count) {
+                    std::destroy_n(to + first, count);
+                });
+            if constexpr (!IsTriviallyRelocatableV<T>) {
+                DestroyChunks(policy, from, size_);
+            }
+            data_.Swap(new_data);
+            generation_.Next();
         }
-        data_.Swap(new_data);
-        std::destroy_n(new_data.GetAddress(), size_);
+    }
+
+    // Уменьшает вместимость до max(capacity, Size()), возвращая лишнюю память аллокатору
+    void ShrinkTo(size_t capacity) {
+        capacity = RoundCapacity(std::max(capacity, size_));
+        if (capacity >= data_.Capacity()) {
+            return;
+        }
+        ChangeCapacity(capacity);
+    }
+
+    void ShrinkToFit() {
+        ShrinkTo(size_);
+    }
+
+    // Уничтожает все элементы, сохраняя вместимость
+    void Clear() noexcept {
+        std::destroy_n(data_.GetAddress(), size_);
+        size_ = 0;
+    }
+
+    template <ExecutionPolicy Policy>
+    void Clear(const Policy& policy) noexcept {
+        DestroyChunks(policy, data_.GetAddress(), size_);
+        size_ = 0;
     }
 
     ~Vector() {
+        VectorStats<T>::OnRelease(data_.Capacity(), size_);
         std::destroy_n(data_.GetAddress(), size_);
     }
 
@@ -227,119 +1426,551 @@ public:
         return data_.Capacity();
     }
 
+    const Allocator& GetAllocator() const noexcept {
+        return data_.GetAllocator();
+    }
+
     const T& operator[](size_t index) const noexcept {
         return const_cast<Vector&>(*this)[index];
     }
 
     T& operator[](size_t index) noexcept {
-        assert(index < size_);
+        Check(index < size_, "index out of range");
         return data_[index];
     }
 
+    // Адрес первого элемента. В отличие от итераторов не проверяется
+    T* Data() noexcept {
+        return data_.GetAddress();
+    }
+
+    const T* Data() const noexcept {
+        return data_.GetAddress();
+    }
+
+    std::span<T> AsSpan() noexcept {
+        return {data_.GetAddress(), size_};
+    }
+
+    std::span<const T> AsSpan() const noexcept {
+        return {data_.GetAddress(), size_};
+    }
+
+    // Отдаёт буфер с элементами вызывающей стороне и оставляет вектор пустым. Элементы
+    // встроенного буфера сначала переносятся в память, выделенную аллокатором
+    [[nodiscard]] ReleasedBuffer<T> Release() {
+        if constexpr (InlineCapacity > 0) {
+            if (data_.IsInline()) {
+                if (size_ == 0) {
+                    return {};
+                }
+                RawMemory<T, Allocator> heap_data(size_, GetAllocator());
+                UninitializedTransferN(data_.GetAddress(), size_, heap_data.GetAddress());
+                DestroyTransferred(data_.GetAddress(), size_);
+                ReleasedBuffer<T> result = heap_data.Release();
+                result.size = std::exchange(size_, 0);
+                generation_.Next();
+                return result;
+            }
+        }
+        VectorStats<T>::OnRelease(data_.Capacity(), size_);
+        ReleasedBuffer<T> result = data_.Release();
+        result.size = std::exchange(size_, 0);
+        generation_.Next();
+        return result;
+    }
+
     Vector& operator=(const Vector& rhs) {
         if (this != &rhs) {
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+                if (GetAllocator() != rhs.GetAllocator()) {
+                    // Память, выделенную прежним аллокатором, нужно вернуть ему же
+                    std::destroy_n(data_.GetAddress(), size_);
+                    size_ = 0;
+                    data_.Reset(rhs.GetAllocator());
+                    generation_.Next();
+                }
+            }
             if (rhs.size_ > data_.Capacity()) {
-                Vector rhs_copy(rhs);
-                Swap(rhs_copy);
+                // Новый буфер выделяется один раз; старые элементы уничтожаются
+                // только после успешного копирования
+                RawMemory<T, Allocator, InlineCapacity> new_data(RoundCapacity(rhs.size_), GetAllocator());
+                UninitializedCopyN(rhs.data_.GetAddress(), rhs.size_, new_data.GetAddress());
+                VectorStats<T>::OnReallocate(data_.Capacity(), size_);
+                std::destroy_n(data_.GetAddress(), size_);
+                data_.Swap(new_data);
+                generation_.Next();
+            } else if constexpr (std::is_trivially_copyable_v<T>) {
+                if (rhs.size_ != 0) {
+                    std::memcpy(static_cast<void*>(data_.GetAddress()), static_cast<const void*>(rhs.data_.GetAddress()),
+                                rhs.size_ * sizeof(T));
+                }
             } else {
                 /* Скопировать элементы из rhs, создав при необходимости новые
                    или удалив существующие */
                 if (size_ >= rhs.size_) {
-                    std::copy(rhs.begin(), rhs.end(), this->begin());
-                    std::destroy_n(begin() + rhs.size_, size_ - rhs.size_);
+                    std::copy(rhs.data_ + 0, rhs.data_ + rhs.size_, data_ + 0);
+                    std::destroy_n(data_ + rhs.size_, size_ - rhs.size_);
                 } else {
-                    std::copy(rhs.begin(), rhs.begin() + size_, this->begin());
-                    std::uninitialized_copy(rhs.begin() + size_, rhs.end(), this->end());
+                    std::copy(rhs.data_ + 0, rhs.data_ + size_, data_ + 0);
+                    std::uninitialized_copy(rhs.data_ + size_, rhs.data_ + rhs.size_, data_ + size_);
                 }
-                size_ = rhs.size_;
             }
+            size_ = rhs.size_;
         }
         return *this;
     }
 
-    Vector& operator=(Vector&& rhs) noexcept {
-        data_ = std::move(rhs.data_);
-        size_ = std::move(rhs.size_);
-        rhs.size_ = 0;
+    Vector& operator=(Vector&& rhs) noexcept((AllocTraits::propagate_on_container_move_assignment::value
+                                              || AllocTraits::is_always_equal::value)
+                                             && (InlineCapacity == 0 || NOTHROW_TRANSFER)) {
+        if (this == &rhs) {
+            return *this;
+        }
+        std::destroy_n(data_.GetAddress(), size_);
+        size_ = 0;
+        generation_.Next();
+        if constexpr (AllocTraits::propagate_on_container_move_assignment::value
+                      || AllocTraits::is_always_equal::value) {
+            data_ = std::move(rhs.data_);
+        } else if (GetAllocator() == rhs.GetAllocator()) {
+            data_ = std::move(rhs.data_);
+        } else {
+            // Память rhs принадлежит чужому аллокатору, поэтому элементы перемещаются по одному
+            Reserve(rhs.size_);
+            std::uninitialized_move_n(rhs.data_.GetAddress(), rhs.size_, data_.GetAddress());
+            size_ = rhs.size_;
+            std::destroy_n(rhs.data_.GetAddress(), rhs.size_);
+            rhs.size_ = 0;
+            rhs.generation_.Next();
+            return *this;
+        }
+        if constexpr (InlineCapacity > 0) {
+            if (data_.IsInline()) {
+                UninitializedTransferN(rhs.data_.GetAddress(), rhs.size_, data_.GetAddress());
+                DestroyTransferred(rhs.data_.GetAddress(), rhs.size_);
+                size_ = std::exchange(rhs.size_, 0);
+                rhs.generation_.Next();
+                return *this;
+            }
+        }
+        size_ = std::exchange(rhs.size_, 0);
+        // Буфер rhs переходит вместе со своим счётчиком; rhs получает прежний счётчик
+        // этого вектора, уже отметивший освобождение старого буфера
+        generation_.Swap(rhs.generation_);
         return *this;
     }
 
-    void Swap(Vector& other) noexcept {
+    void Swap(Vector& other) noexcept(InlineCapacity == 0 || NOTHROW_TRANSFER) {
+        if constexpr (InlineCapacity > 0) {
+            if (data_.IsInline() || other.data_.IsInline()) {
+                Vector tmp(std::move(other));
+                other = std::move(*this);
+                *this = std::move(tmp);
+                return;
+            }
+        }
         data_.Swap(other.data_);
         std::swap(size_, other.size_);
+        generation_.Swap(other.generation_);
     }
 
 private:
-    RawMemory<T> data_;
+    // Буфер можно расширять на месте, не создавая новый и не перенося элементы
+    static constexpr bool CAN_REALLOCATE = IsTriviallyRelocatableV<T> && ReallocatingAllocator<Allocator>;
+    // Перенос элементов в другой буфер не выбрасывает исключений
+    static constexpr bool NOTHROW_TRANSFER = IsTriviallyRelocatableV<T> || std::is_nothrow_move_constructible_v<T>;
+
+    RawMemory<T, Allocator, InlineCapacity> data_;
     size_t size_ = 0;
+    [[no_unique_address]] BufferGeneration<> generation_;
 
-    template <typename... Args>
-    iterator EmplaceNotEnoughCapacity(const_iterator pos, Args&&... args) {
-        size_t num_pos = std::distance(cbegin(), pos);
-        size_t ns;
-        if (size_ > 0) {
-            ns = size_ * 2;
+    iterator MakeIterator(T* ptr) noexcept {
+        if constexpr (VECTOR_CHECKED_ITERATORS) {
+            return iterator(ptr, generation_.Get());
+        } else {
+            return ptr;
+        }
+    }
+
+    const_iterator MakeIterator(const T* ptr) const noexcept {
+        if constexpr (VECTOR_CHECKED_ITERATORS) {
+            return const_iterator(ptr, generation_.Get());
+        } else {
+            return ptr;
+        }
+    }
+
+    static void Check(bool condition, const char* message) noexcept {
+        if constexpr (VECTOR_BOUNDS_CHECKS) {
+            if (!condition) [[unlikely]] {
+                VectorCheckFailed(message);
+            }
+        }
+    }
+
+    // Номер позиции pos; на уровне проверок 2 заодно проверяется поколение итератора
+    size_t ToIndex(const_iterator pos) const noexcept {
+        const T* ptr = nullptr;
+        if constexpr (VECTOR_CHECKED_ITERATORS) {
+            ptr = pos.Get();
+        } else {
+            ptr = pos;
+        }
+        Check(!std::less<const T*>{}(ptr, data_ + 0) && !std::less<const T*>{}(data_ + size_, ptr),
+              "position does not belong to the vector");
+        return static_cast<size_t>(ptr - (data_ + 0));
+    }
+
+    static size_t RoundCapacity(size_t capacity) noexcept {
+        if constexpr (RoundingGrowthPolicy<GrowthPolicy>) {
+            return GrowthPolicy::RoundCapacity(capacity);
+        } else {
+            return capacity;
+        }
+    }
+
+    // Переносит n элементов из from в неинициализированную память to.
+    // Тривиально перемещаемые типы переносятся одним memcpy, остальные перемещаются,
+    // если перемещение не выбрасывает исключений, и копируются в противном случае
+    static void UninitializedTransferN(T* from, size_t n, T* to) {
+        if constexpr (IsTriviallyRelocatableV<T>) {
+            if (n != 0) {
+                std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), n * sizeof(T));
+            }
+            VectorStats<T>::OnRelocateByMemcpy(n);
+        } else if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            std::uninitialized_move_n(from, n, to);
+            VectorStats<T>::OnRelocateByMove(n);
         } else {
-            ns = 1;
-        }
-        RawMemory<T> new_data(ns);
-        // constexpr оператор if будет вычислен во время компиляции
-        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-            new (new_data + num_pos) T(std::forward<Args>(args)...);
-            std::uninitialized_move_n(data_.GetAddress(), num_pos, new_data.GetAddress());
-            if (pos != cend()) {
-                std::uninitialized_move_n(data_ + num_pos, size_ - num_pos, new_data + num_pos + 1);
+            std::uninitialized_copy_n(from, n, to);
+            VectorStats<T>::OnRelocateByCopy(n);
+        }
+    }
+
+    // Копирует n элементов в неинициализированную память; тривиально копируемые — одним memcpy
+    static void UninitializedCopyN(const T* from, size_t n, T* to) {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            if (n == 0) {
+                return;
+            }
+            // Размер живого массива не превышает PTRDIFF_MAX байт. Это предусловие, а не проверка:
+            // подсказка лишь не даёт GCC вывести невозможную длину и предупредить о memcpy
+            assert(n <= static_cast<size_t>(std::numeric_limits<std::ptrdiff_t>::max()) / sizeof(T));
+#if defined(__GNUC__) || defined(__clang__)
+            if (n > static_cast<size_t>(std::numeric_limits<std::ptrdiff_t>::max()) / sizeof(T)) {
+                __builtin_unreachable();
+            }
+#endif
+            std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), n * sizeof(T));
+        } else {
+            std::uninitialized_copy_n(from, n, to);
+        }
+    }
+
+    // Уничтожает исходные элементы после UninitializedTransferN.
+    // После memcpy объекты уже считаются перенесёнными, и деструкторы не вызываются
+    static void DestroyTransferred(T* from, size_t n) noexcept {
+        if constexpr (!IsTriviallyRelocatableV<T>) {
+            std::destroy_n(from, n);
+        }
+    }
+
+    // Переносит элементы в буфер вместимостью new_capacity >= size_. Строгая гарантия
+    // сохраняется: при исключении во время копирования вектор не изменяется
+    void ChangeCapacity(size_t new_capacity) {
+        assert(new_capacity >= size_);
+        VectorStats<T>::OnReallocate(data_.Capacity(), size_);
+        generation_.Next();
+        if constexpr (CAN_REALLOCATE) {
+            data_.Reallocate(new_capacity);
+            return;
+        }
+        if constexpr (InlineCapacity > 0) {
+            if (new_capacity <= InlineCapacity) {
+                if (data_.IsInline()) {
+                    return;
+                }
+                // Элементы возвращаются из кучи во встроенный буфер
+                RawMemory<T, Allocator, InlineCapacity> heap_data(std::move(data_));
+                try {
+                    UninitializedTransferN(heap_data.GetAddress(), size_, data_.GetAddress());
+                } catch (...) {
+                    data_ = std::move(heap_data);
+                    throw;
+                }
+                DestroyTransferred(heap_data.GetAddress(), size_);
+                return;
+            }
+        }
+        RawMemory<T, Allocator, InlineCapacity> new_data(new_capacity, data_.GetAllocator());
+        UninitializedTransferN(data_.GetAddress(), size_, new_data.GetAddress());
+        DestroyTransferred(data_.GetAddress(), size_);
+        data_.Swap(new_data);
+    }
+
+    // Создаёт n элементов в dst по участкам при помощи construct(dst, n)
+    template <ExecutionPolicy Policy, typename Construct>
+    static void ConstructChunks(const Policy& policy, T* dst, size_t n, Construct construct) {
+        ForEachChunk(
+            policy, n,
+            [dst, &construct](size_t first, size_t count) {
+                construct(dst + first, count);
+            },
+            [dst](size_t first, size_t count) {
+                std::destroy_n(dst + first, count);
+            });
+    }
+
+    template <ExecutionPolicy Policy>
+    static void DestroyChunks(const Policy& policy, T* from, size_t n) noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            try {
+                ForEachChunk(
+                    policy, n,
+                    [from](size_t first, size_t count) noexcept {
+                        std::destroy_n(from + first, count);
+                    },
+                    [](size_t, size_t) noexcept {});
+            } catch (...) {
+                // Исключение возможно только при подготовке, до уничтожения первого участка
+                std::destroy_n(from, n);
+            }
+        }
+    }
+
+    // Изменяет размер, создавая недостающие элементы при помощи construct(dst, n)
+    template <typename Construct>
+    void ResizeWith(size_t new_size, Construct&& construct) {
+        if (size_ > new_size) {
+            std::destroy_n(data_ + new_size, size_ - new_size);
+        } else if (size_ < new_size) {
+            Reserve(new_size);
+            construct(data_ + size_, new_size - size_);
+        }
+        size_ = new_size;
+    }
+
+    // Вставляет count элементов в позицию num_pos. construct(dst, n) создаёт n элементов
+    // в неинициализированной памяти dst и при исключении уничтожает уже созданные
+    template <typename Construct>
+    iterator InsertN(size_t num_pos, size_t count, Construct&& construct) {
+        if (count == 0) {
+            return begin() + num_pos;
+        }
+        const size_t tail = size_ - num_pos;
+        if (size_ + count > Capacity()) {
+            VectorStats<T>::OnReallocate(data_.Capacity(), size_);
+            const size_t new_capacity =
+                RoundCapacity(std::max(GrowthPolicy::NextCapacity(size_, sizeof(T)), size_ + count));
+            RawMemory<T, Allocator, InlineCapacity> new_data(new_capacity, data_.GetAllocator());
+            construct(new_data + num_pos, count);
+            try {
+                UninitializedTransferN(data_.GetAddress(), num_pos, new_data.GetAddress());
+            } catch (...) {
+                std::destroy_n(new_data + num_pos, count);
+                throw;
+            }
+            try {
+                UninitializedTransferN(data_ + num_pos, tail, new_data + num_pos + count);
+            } catch (...) {
+                std::destroy_n(new_data.GetAddress(), num_pos + count);
+                throw;
+            }
+            DestroyTransferred(data_.GetAddress(), size_);
+            data_.Swap(new_data);
+            generation_.Next();
+        } else if constexpr (IsTriviallyRelocatableV<T>) {
+            T* gap = data_ + num_pos;
+            std::memmove(static_cast<void*>(gap + count), static_cast<const void*>(gap), tail * sizeof(T));
+            try {
+                construct(gap, count);
+            } catch (...) {
+                std::memmove(static_cast<void*>(gap), static_cast<const void*>(gap + count), tail * sizeof(T));
+                throw;
             }
         } else {
-            new (new_data + num_pos) T(std::forward<Args>(args)...);
-            std::uninitialized_copy_n(data_.GetAddress(), num_pos, new_data.GetAddress());
-            if (pos != cend()) {
-                std::uninitialized_copy_n(data_ + num_pos, size_ - num_pos, new_data + num_pos + 1);
+            // Новые элементы создаются за концом и переставляются на место одним проходом
+            // Размер обновляется до перестановки: если перемещение выбросит исключение,
+            // все элементы останутся учтены
+            construct(data_ + size_, count);
+            size_ += count;
+            std::rotate(data_ + num_pos, data_ + size_ - count, data_ + size_);
+            return begin() + num_pos;
+        }
+        size_ += count;
+        return begin() + num_pos;
+    }
+
+    template <typename... Args>
+    iterator EmplaceNotEnoughCapacity(const_iterator pos, Args&&... args) {
+        size_t num_pos = ToIndex(pos);
+        const size_t ns = RoundCapacity(std::max(GrowthPolicy::NextCapacity(size_, sizeof(T)), size_ + 1));
+        VectorStats<T>::OnReallocate(data_.Capacity(), size_);
+        if constexpr (CAN_REALLOCATE) {
+            // Элемент создаётся до реаллокации, так как аргументы могут ссылаться на элементы вектора
+            alignas(T) std::byte value_storage[sizeof(T)];
+            T* value = new (value_storage) T(std::forward<Args>(args)...);
+            try {
+                data_.Reallocate(ns);
+            } catch (...) {
+                std::destroy_at(value);
+                throw;
             }
+            std::memmove(static_cast<void*>(data_ + num_pos + 1), static_cast<const void*>(data_ + num_pos),
+                         (size_ - num_pos) * sizeof(T));
+            std::memcpy(static_cast<void*>(data_ + num_pos), static_cast<const void*>(value), sizeof(T));
+            ++size_;
+            generation_.Next();
+            return begin() + num_pos;
+        }
+        RawMemory<T, Allocator, InlineCapacity> new_data(ns, data_.GetAllocator());
+        new (new_data + num_pos) T(std::forward<Args>(args)...);
+        try {
+            UninitializedTransferN(data_.GetAddress(), num_pos, new_data.GetAddress());
+        } catch (...) {
+            std::destroy_at(new_data + num_pos);
+            throw;
         }
+        try {
+            UninitializedTransferN(data_ + num_pos, size_ - num_pos, new_data + num_pos + 1);
+        } catch (...) {
+            std::destroy_n(new_data.GetAddress(), num_pos + 1);
+            throw;
+        }
+        DestroyTransferred(data_.GetAddress(), size_);
         data_.Swap(new_data);
-        std::destroy_n(new_data.GetAddress(), size_);
         ++size_;
-        return &data_[num_pos];
+        generation_.Next();
+        return begin() + num_pos;
+    }
+
+    // Аргументы, которые можно передать конструктору в целевой ячейке после сдвига хвоста:
+    // их нет, или это единственный объект типа T, адрес которого пересчитывается при сдвиге.
+    // Другие аргументы могут ссылаться на части сдвигаемых элементов
+    template <typename... Args>
+    static constexpr bool CAN_CONSTRUCT_AFTER_SHIFT =
+        sizeof...(Args) == 0 || (sizeof...(Args) == 1 && (std::is_same_v<std::remove_cvref_t<Args>, T> && ...));
+
+    // Если value — элемент хвоста [num_pos, size_), то после сдвига хвоста на одну позицию
+    // он окажется по адресу на единицу больше
+    template <typename Arg>
+    Arg&& ShiftedArgument(Arg&& value, size_t num_pos) noexcept {
+        const T* address = std::addressof(value);
+        if (!std::less<const T*>{}(address, data_ + num_pos) && std::less<const T*>{}(address, data_ + size_)) {
+            ++address;
+        }
+        return std::forward<Arg>(const_cast<std::remove_reference_t<Arg>&>(*address));
     }
 
     template <typename... Args>
     iterator EmplaceEnoughCapacity(const_iterator pos, Args&&... args) {
-        size_t num_pos = std::distance(cbegin(), pos);
-        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-            EmplaceWMove(num_pos, std::forward<Args>(args)...);
+        const size_t num_pos = ToIndex(pos);
+        T* slot = data_ + num_pos;
+        if (num_pos == size_) {
+            new (slot) T(std::forward<Args>(args)...);
+            ++size_;
+        } else if constexpr (IsTriviallyRelocatableV<T>) {
+            EmplaceRelocatingTail(num_pos, std::forward<Args>(args)...);
         } else {
-            EmplaceWCopy(num_pos, std::forward<Args>(args)...);
+            EmplaceShiftingTail(num_pos, std::forward<Args>(args)...);
         }
-        ++size_;
-        return &data_[num_pos];
+        return begin() + num_pos;
     }
 
-    // Использовать только если capacity позволяет добавить элемент
+    // Хвост сдвигается одним memmove. Если аргументы не ссылаются на сдвигаемые элементы,
+    // новый элемент создаётся сразу в своей ячейке, иначе — во временном буфере,
+    // откуда переносится memcpy
     template <typename... Args>
-    void EmplaceWMove(size_t num_pos, Args&&... args) {
-        if (size_ > 0 && num_pos != size_) {
-            T tmp_val(std::forward<Args>(args)...);
-            new (data_ + size_) T(std::move(data_[size_ - 1]));
-            
-            std::move_backward(data_ + num_pos, data_ + (size_ - 1), data_ + size_);  
-            data_[num_pos] = std::move(tmp_val);
+    void EmplaceRelocatingTail(size_t num_pos, Args&&... args) {
+        T* slot = data_ + num_pos;
+        const size_t tail_bytes = (size_ - num_pos) * sizeof(T);
+        if constexpr (CAN_CONSTRUCT_AFTER_SHIFT<Args...>) {
+            auto shifted_args = std::forward_as_tuple(ShiftedArgument(std::forward<Args>(args), num_pos)...);
+            std::memmove(static_cast<void*>(slot + 1), static_cast<const void*>(slot), tail_bytes);
+            try {
+                std::apply(
+                    [slot](auto&&... shifted) {
+                        new (slot) T(std::forward<decltype(shifted)>(shifted)...);
+                    },
+                    std::move(shifted_args));
+            } catch (...) {
+                std::memmove(static_cast<void*>(slot), static_cast<const void*>(slot + 1), tail_bytes);
+                throw;
+            }
         } else {
-            new (data_ + num_pos) T(std::forward<Args>(args)...);
+            alignas(T) std::byte value_storage[sizeof(T)];
+            new (value_storage) T(std::forward<Args>(args)...);
+            std::memmove(static_cast<void*>(slot + 1), static_cast<const void*>(slot), tail_bytes);
+            std::memcpy(static_cast<void*>(slot), static_cast<const void*>(value_storage), sizeof(T));
         }
+        ++size_;
     }
 
-    // Использовать только если capacity позволяет добавить элемент
+    // Последний элемент переносится в свободную ячейку за концом, остальные сдвигаются
+    // присваиванием, после чего новое значение присваивается в освободившуюся ячейку.
+    // Единственный аргумент типа T присваивается напрямую, без временного объекта
     template <typename... Args>
-    void EmplaceWCopy(size_t num_pos, Args&&... args) {
-        if (size_ > 0 && num_pos != size_) {
-            T tmp_val(std::forward<Args>(args)...);
-            new (data_ + size_) T(std::move(data_[size_ - 1]));
-            
-            std::copy_backward(data_ + num_pos, data_ + (size_ - 1), data_ + size_);  
-            data_[num_pos] = std::move(tmp_val);
+    void EmplaceShiftingTail(size_t num_pos, Args&&... args) {
+        if constexpr (sizeof...(Args) == 1 && CAN_CONSTRUCT_AFTER_SHIFT<Args...>) {
+            auto shifted_args = std::forward_as_tuple(ShiftedArgument(std::forward<Args>(args), num_pos)...);
+            ShiftTailRight(num_pos);
+            data_[num_pos] = std::get<0>(std::move(shifted_args));
         } else {
-            new (data_ + num_pos) T(std::forward<Args>(args)...);
+            T value(std::forward<Args>(args)...);
+            ShiftTailRight(num_pos);
+            data_[num_pos] = std::move(value);
         }
     }
-};
\ No newline at end of file
+
+    // Сдвигает элементы [num_pos, size_) на одну позицию вправо перемещением. Копирование
+    // не дало бы строгой гарантии: исключение при присваивании всё равно оставит хвост
+    // частично сдвинутым. Размер увеличивается сразу после создания нового последнего элемента,
+    // поэтому при исключении все созданные элементы остаются учтены
+    void ShiftTailRight(size_t num_pos) {
+        new (data_ + size_) T(std::move(data_[size_ - 1]));
+        ++size_;
+        std::move_backward(data_ + num_pos, data_ + (size_ - 2), data_ + (size_ - 1));
+    }
+};
+
+}  // namespace VECTOR_CHECK_NAMESPACE(VECTOR_CHECK_LEVEL)
+
+// Удаляет из вектора элементы, удовлетворяющие pred, за один проход и возвращает их количество
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity, typename Predicate>
+size_t EraseIf(Vector<T, Allocator, GrowthPolicy, InlineCapacity>& v, Predicate pred) {
+    const auto new_end = std::remove_if(v.begin(), v.end(), pred);
+    const size_t removed = std::distance(new_end, v.end());
+    v.Erase(new_end, v.end());
+    return removed;
+}
+
+// Вектор, хранящий до N элементов во встроенном буфере без обращения к аллокатору
+template <typename T, size_t N, typename Allocator = std::allocator<T>, typename GrowthPolicy = DoublingGrowth<>>
+using SmallVector = Vector<T, Allocator, GrowthPolicy, N>;
+
+// Вектор, который может принимать во владение внешние буферы со своим deleter
+template <typename T>
+using AdoptingVector = Vector<T, AdoptingAllocator<T>>;
+
+// Создаёт вектор поверх внешнего буфера data без копирования; deleter(data, capacity)
+// освободит буфер после уничтожения элементов
+template <typename T>
+AdoptingVector<T> AdoptVector(T* data, size_t size, size_t capacity, BufferDeleter<T> deleter) {
+    return AdoptingVector<T>(adopt_buffer, data, size, capacity, AdoptingAllocator<T>(data, std::move(deleter)));
+}
+
+// Вектор с буфером, выровненным по Alignment байт. При PadCapacity вместимость кратна
+// числу элементов, умещающихся в Alignment байт
+template <typename T, size_t Alignment = 64, bool PadCapacity = true>
+using AlignedVector = Vector<T, AlignedAllocator<T, Alignment>,
+                             std::conditional_t<PadCapacity, PaddedGrowth<std::max<size_t>(Alignment / sizeof(T), 1)>,
+                                                DoublingGrowth<>>>;
+
+namespace pmr {
+
+// Вектор, память которого выделяется из std::pmr::memory_resource (арены, пулы)
+template <typename T, typename GrowthPolicy = DoublingGrowth<>>
+using Vector = ::Vector<T, std::pmr::polymorphic_allocator<T>, GrowthPolicy>;
+
+}  // namespace pmr
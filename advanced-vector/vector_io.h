@@ -0,0 +1,294 @@
+#pragma once
+
+#include "vector.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#if defined(__unix__)
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+// Данные, объём которых заранее неизвестен, читаются участками такого размера: число элементов
+// из повреждённого заголовка не приводит к выделению памяти сверх реально прочитанного
+inline constexpr size_t VECTOR_IO_CHUNK_BYTES = size_t{1} << 20;
+
+template <typename T>
+inline constexpr size_t VECTOR_IO_CHUNK_ELEMENTS = std::max<size_t>(VECTOR_IO_CHUNK_BYTES / sizeof(T), 1);
+
+// Двоичная сериализация Vector. Формат: заголовок (сигнатура, размер элемента, число элементов)
+// и элементы в порядке байтов текущей платформы. Тривиально копируемые элементы
+// записываются одним блоком прямо из буфера вектора и читаются прямо в него.
+// Для остальных типов нужна специализация VectorSerializer с функциями
+// static void Write(std::ostream& out, const T& value) и static T Read(std::istream& in)
+template <typename T>
+struct VectorSerializer;
+
+template <>
+struct VectorSerializer<std::string> {
+    static void Write(std::ostream& out, const std::string& value) {
+        const uint64_t size = value.size();
+        out.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        out.write(value.data(), static_cast<std::streamsize>(value.size()));
+    }
+
+    static std::string Read(std::istream& in) {
+        uint64_t size = 0;
+        in.read(reinterpret_cast<char*>(&size), sizeof(size));
+        std::string value;
+        while (in && value.size() < size) {
+            const size_t offset = value.size();
+            const size_t n = std::min<uint64_t>(size - offset, VECTOR_IO_CHUNK_BYTES);
+            value.resize(offset + n);
+            in.read(value.data() + offset, static_cast<std::streamsize>(n));
+        }
+        return value;
+    }
+};
+
+template <typename T>
+concept HasVectorSerializer = requires(std::ostream& out, std::istream& in, const T& value) {
+    VectorSerializer<T>::Write(out, value);
+    { VectorSerializer<T>::Read(in) } -> std::convertible_to<T>;
+};
+
+template <typename T>
+concept SerializableElement = std::is_trivially_copyable_v<T> || HasVectorSerializer<T>;
+
+struct VectorIoHeader {
+    char magic[8];
+    uint64_t element_size;
+    uint64_t count;
+
+    static constexpr char MAGIC[8] = {'V', 'E', 'C', 'T', 'O', 'R', '0', '1'};
+
+    static VectorIoHeader For(size_t element_size, size_t count) noexcept {
+        VectorIoHeader header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.element_size = element_size;
+        header.count = count;
+        return header;
+    }
+
+    // Проверяет сигнатуру и размер элемента, а также что данные такого объёма вообще
+    // могут существовать
+    void Check(size_t expected_element_size) const {
+        if (std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || element_size != expected_element_size
+            || count > std::numeric_limits<size_t>::max() / expected_element_size) {
+            throw std::runtime_error("Unexpected vector format");
+        }
+    }
+};
+
+// Увеличивает размер вектора до new_size при чтении участками. Вместимость растёт хотя бы
+// вдвое, но не сверх count, поэтому все участки вместе переносятся за линейное время
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+void GrowForChunk(Vector<T, Allocator, GrowthPolicy, InlineCapacity>& v, size_t new_size, size_t count) {
+    if (new_size > v.Capacity()) {
+        v.Reserve(std::max(new_size, std::min(count, 2 * v.Capacity())));
+    }
+    v.ResizeDefaultInit(new_size);
+}
+
+// Переносимый вариант через std::FILE*, доступный на любой платформе. Файл должен быть
+// открыт в двоичном режиме. Элементы записываются одним fwrite прямо из буфера вектора
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+    requires std::is_trivially_copyable_v<T>
+void WriteTo(std::FILE* file, const Vector<T, Allocator, GrowthPolicy, InlineCapacity>& v) {
+    const VectorIoHeader header = VectorIoHeader::For(sizeof(T), v.Size());
+    if (std::fwrite(&header, sizeof(header), 1, file) != 1
+        || (v.Size() != 0 && std::fwrite(v.Data(), sizeof(T), v.Size(), file) != v.Size())) {
+        throw std::runtime_error("Failed to write vector");
+    }
+}
+
+// Данные читаются участками прямо в буфер вектора. При любой ошибке вектор остаётся пустым
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+    requires std::is_trivially_copyable_v<T>
+void ReadFrom(std::FILE* file, Vector<T, Allocator, GrowthPolicy, InlineCapacity>& v) {
+    v.Clear();
+    VectorIoHeader header;
+    if (std::fread(&header, sizeof(header), 1, file) != 1) {
+        throw std::runtime_error("Unexpected end of vector data");
+    }
+    header.Check(sizeof(T));
+    const size_t count = header.count;
+    try {
+        for (size_t read = 0; read < count;) {
+            const size_t n = std::min(VECTOR_IO_CHUNK_ELEMENTS<T>, count - read);
+            GrowForChunk(v, read + n, count);
+            if (std::fread(v.Data() + read, sizeof(T), n, file) != n) {
+                throw std::runtime_error("Unexpected end of vector data");
+            }
+            read += n;
+        }
+    } catch (...) {
+        v.Clear();
+        throw;
+    }
+}
+
+#if defined(__unix__)
+// Варианты для файловых дескрипторов POSIX: без промежуточной буферизации stdio
+
+// Записывает заголовок и элементы одним writev, дописывая остаток при частичной записи
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+    requires std::is_trivially_copyable_v<T>
+void WriteTo(int fd, const Vector<T, Allocator, GrowthPolicy, InlineCapacity>& v) {
+    VectorIoHeader header = VectorIoHeader::For(sizeof(T), v.Size());
+    iovec parts[] = {
+        {&header, sizeof(header)},
+        {const_cast<T*>(v.Data()), v.Size() * sizeof(T)},
+    };
+    iovec* part = parts;
+    int parts_left = std::size(parts);
+    while (parts_left > 0) {
+        const ssize_t written = ::writev(fd, part, parts_left);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "writev");
+        }
+        auto rest = static_cast<size_t>(written);
+        while (parts_left > 0 && rest >= part->iov_len) {
+            rest -= part->iov_len;
+            ++part;
+            --parts_left;
+        }
+        if (parts_left > 0) {
+            part->iov_base = static_cast<std::byte*>(part->iov_base) + rest;
+            part->iov_len -= rest;
+        }
+    }
+}
+
+// Читает ровно size байт, при преждевременном конце данных выбрасывает std::runtime_error
+inline void ReadExactly(int fd, void* data, size_t size) {
+    auto* dst = static_cast<std::byte*>(data);
+    while (size > 0) {
+        const ssize_t received = ::read(fd, dst, size);
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(), "read");
+        }
+        if (received == 0) {
+            throw std::runtime_error("Unexpected end of vector data");
+        }
+        dst += received;
+        size -= static_cast<size_t>(received);
+    }
+}
+
+// Число байт, оставшихся в обычном файле после текущей позиции; для каналов и сокетов неизвестно
+inline std::optional<uint64_t> RemainingBytes(int fd) noexcept {
+    struct stat info {};
+    if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+        return std::nullopt;
+    }
+    const off_t position = ::lseek(fd, 0, SEEK_CUR);
+    if (position < 0 || position > info.st_size) {
+        return std::nullopt;
+    }
+    return static_cast<uint64_t>(info.st_size - position);
+}
+
+// Данные читаются прямо в буфер вектора. Размер обычного файла сверяется с заголовком заранее,
+// и буфер выделяется один раз; из каналов и сокетов данные читаются участками.
+// При любой ошибке вектор остаётся пустым
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+    requires std::is_trivially_copyable_v<T>
+void ReadFrom(int fd, Vector<T, Allocator, GrowthPolicy, InlineCapacity>& v) {
+    v.Clear();
+    VectorIoHeader header;
+    ReadExactly(fd, &header, sizeof(header));
+    header.Check(sizeof(T));
+    const size_t count = header.count;
+    size_t chunk = VECTOR_IO_CHUNK_ELEMENTS<T>;
+    if (const auto remaining = RemainingBytes(fd)) {
+        if (count * sizeof(T) > *remaining) {
+            throw std::runtime_error("Unexpected end of vector data");
+        }
+        chunk = count;
+    }
+    try {
+        for (size_t read = 0; read < count;) {
+            const size_t n = std::min(chunk, count - read);
+            GrowForChunk(v, read + n, count);
+            ReadExactly(fd, v.Data() + read, n * sizeof(T));
+            read += n;
+        }
+    } catch (...) {
+        v.Clear();
+        throw;
+    }
+}
+#endif
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+    requires SerializableElement<T>
+void WriteTo(std::ostream& out, const Vector<T, Allocator, GrowthPolicy, InlineCapacity>& v) {
+    const VectorIoHeader header = VectorIoHeader::For(sizeof(T), v.Size());
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        out.write(reinterpret_cast<const char*>(v.Data()), static_cast<std::streamsize>(v.Size() * sizeof(T)));
+    } else {
+        for (const T& value : v) {
+            VectorSerializer<T>::Write(out, value);
+        }
+    }
+    if (!out) {
+        throw std::runtime_error("Failed to write vector");
+    }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, size_t InlineCapacity>
+    requires SerializableElement<T>
+void ReadFrom(std::istream& in, Vector<T, Allocator, GrowthPolicy, InlineCapacity>& v) {
+    v.Clear();
+    VectorIoHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        throw std::runtime_error("Unexpected end of vector data");
+    }
+    header.Check(sizeof(T));
+    const size_t count = header.count;
+    try {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            // Объём потока заранее неизвестен, поэтому вектор растёт по мере чтения
+            for (size_t read = 0; read < count && in;) {
+                const size_t n = std::min(VECTOR_IO_CHUNK_ELEMENTS<T>, count - read);
+                GrowForChunk(v, read + n, count);
+                in.read(reinterpret_cast<char*>(v.Data() + read), static_cast<std::streamsize>(n * sizeof(T)));
+                read += n;
+            }
+        } else {
+            v.Reserve(std::min(count, VECTOR_IO_CHUNK_ELEMENTS<T>));
+            for (size_t i = 0; i < count && in; ++i) {
+                v.EmplaceBack(VectorSerializer<T>::Read(in));
+            }
+        }
+        if (!in) {
+            throw std::runtime_error("Unexpected end of vector data");
+        }
+    } catch (...) {
+        v.Clear();
+        throw;
+    }
+}
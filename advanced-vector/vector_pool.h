@@ -0,0 +1,183 @@
+#pragma once
+
+#include "vector.h"
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+// Пул векторов с сохранённой вместимостью. У каждого потока свой список свободных векторов,
+// поэтому Acquire и Release не синхронизируются между потоками и не обращаются к аллокатору,
+// пока в списке есть подходящий вектор. Возвращённый вектор очищается, но память не
+// освобождается. Потоку разрешено хранить не больше MaxRetainedBytes байт вместимости,
+// лишние векторы освобождаются сразу. Вектор, возвращённый в другом потоке, попадает
+// в список этого потока. Списки освобождаются при завершении потоков; вектор, возвращённый
+// после этого (например, из деструктора thread_local или статического объекта), освобождается сразу
+template <typename T, size_t MaxRetainedBytes = size_t{1} << 20, typename Allocator = std::allocator<T>,
+          typename GrowthPolicy = DoublingGrowth<>>
+class VectorPool {
+    // Векторы с разными экземплярами аллокатора нельзя смешивать в одном списке
+    static_assert(std::allocator_traits<Allocator>::is_always_equal::value,
+                  "VectorPool requires an allocator that is always equal");
+
+public:
+    using Values = Vector<T, Allocator, GrowthPolicy>;
+
+    // Владеет вектором из пула и возвращает его в пул при уничтожении
+    class [[nodiscard]] Handle {
+    public:
+        Handle() = default;
+
+        explicit Handle(Values values) noexcept
+            : values_(std::move(values))
+            , owns_(true) {
+        }
+
+        Handle(Handle&& other) noexcept
+            : values_(std::move(other.values_))
+            , owns_(std::exchange(other.owns_, false)) {
+        }
+
+        Handle& operator=(Handle&& rhs) noexcept {
+            if (this != &rhs) {
+                Reset();
+                values_ = std::move(rhs.values_);
+                owns_ = std::exchange(rhs.owns_, false);
+            }
+            return *this;
+        }
+
+        Handle(const Handle&) = delete;
+        Handle& operator=(const Handle&) = delete;
+
+        ~Handle() {
+            Reset();
+        }
+
+        Values& operator*() noexcept {
+            return values_;
+        }
+
+        Values* operator->() noexcept {
+            return &values_;
+        }
+
+        // Возвращает вектор в пул досрочно
+        void Reset() noexcept {
+            if (std::exchange(owns_, false)) {
+                Release(std::move(values_));
+            }
+        }
+
+        // Забирает вектор из-под управления пула
+        Values Detach() noexcept {
+            owns_ = false;
+            return std::move(values_);
+        }
+
+    private:
+        Values values_;
+        bool owns_ = false;
+    };
+
+    // Выдаёт пустой вектор вместимостью не меньше min_capacity. Предпочитается последний
+    // возвращённый подходящий вектор: его память, скорее всего, ещё в кэше
+    static Values AcquireValues(size_t min_capacity = 0) {
+        if (IsFreeListDestroyed()) {
+            Values result;
+            result.Reserve(min_capacity);
+            return result;
+        }
+        FreeList& list = GetFreeList();
+        for (size_t i = list.values.Size(); i > 0; --i) {
+            if (list.values[i - 1].Capacity() >= min_capacity) {
+                return list.Take(i - 1);
+            }
+        }
+        Values result;
+        if (list.values.Size() > 0) {
+            // Подходящего нет: самый свежий вектор расширяется, а не создаётся новый
+            result = list.Take(list.values.Size() - 1);
+        }
+        result.Reserve(min_capacity);
+        return result;
+    }
+
+    static Handle Acquire(size_t min_capacity = 0) {
+        return Handle(AcquireValues(min_capacity));
+    }
+
+    // Очищает вектор и оставляет его память в списке потока, если не превышен лимит.
+    // Отклонённый вектор освобождается до возврата: values в любом случае остаётся пустым
+    static void Release(Values&& values) noexcept {
+        Values released = std::move(values);
+        released.Clear();
+        const size_t bytes = released.Capacity() * sizeof(T);
+        if (bytes == 0 || IsFreeListDestroyed()) {
+            return;
+        }
+        FreeList& list = GetFreeList();
+        if (list.retained_bytes + bytes > MaxRetainedBytes) {
+            return;
+        }
+        try {
+            list.values.PushBack(std::move(released));
+        } catch (...) {
+            // Не удалось расширить сам список: вектор просто освобождается
+            return;
+        }
+        list.retained_bytes += bytes;
+    }
+
+    // Объём памяти, удерживаемой списком текущего потока
+    static size_t RetainedBytes() noexcept {
+        return IsFreeListDestroyed() ? 0 : GetFreeList().retained_bytes;
+    }
+
+    static size_t PooledCount() noexcept {
+        return IsFreeListDestroyed() ? 0 : GetFreeList().values.Size();
+    }
+
+    // Освобождает все векторы из списка текущего потока
+    static void Trim() noexcept {
+        if (IsFreeListDestroyed()) {
+            return;
+        }
+        FreeList& list = GetFreeList();
+        list.values = Vector<Values>();
+        list.retained_bytes = 0;
+    }
+
+private:
+    struct FreeList {
+        Vector<Values> values;
+        size_t retained_bytes = 0;
+
+        ~FreeList() {
+            FreeListDestroyedFlag() = true;
+        }
+
+        Values Take(size_t index) noexcept {
+            Values result = std::move(values[index]);
+            retained_bytes -= result.Capacity() * sizeof(T);
+            values.Erase(values.begin() + index);
+            return result;
+        }
+    };
+
+    // Флаг инициализируется константой и не имеет деструктора, поэтому доступен и после
+    // уничтожения списка при завершении потока
+    static bool& FreeListDestroyedFlag() noexcept {
+        thread_local bool destroyed = false;
+        return destroyed;
+    }
+
+    static bool IsFreeListDestroyed() noexcept {
+        return FreeListDestroyedFlag();
+    }
+
+    static FreeList& GetFreeList() noexcept {
+        thread_local FreeList list;
+        return list;
+    }
+};